@@ -118,13 +118,39 @@ namespace iosync
 				localFrame = 0;
 			}
 
-			this_thread::sleep_for(delayAmount);
+			if (sampleRate <= updateRate)
+			{
+				this_thread::sleep_for(delayAmount);
+
+				continue;
+			}
+
+			// Sample at 'sampleRate' until this frame's delay is over:
+			auto sampleDelay = (chrono::microseconds)(1000000/sampleRate);
+
+			auto frameEnd = (chrono::steady_clock::now() + delayAmount);
+
+			for (auto nextSample = (chrono::steady_clock::now() + sampleDelay); nextSample < frameEnd; nextSample += sampleDelay)
+			{
+				this_thread::sleep_until(nextSample);
+
+				sample();
+			}
+
+			this_thread::sleep_until(frameEnd);
 		}
 
 		// Return the default response.
 		return 0;
 	}
 
+	void application::sample()
+	{
+		// Nothing so far.
+
+		return;
+	}
+
 	nativeWindow application::getWindow() const
 	{
 		return WINDOW_NONE;
@@ -139,6 +165,11 @@ namespace iosync
 		return false;
 	}
 
+	subscriptionChannels application::getNetworkMessageChannels(QSocket&, const messageHeader&)
+	{
+		return SUBSCRIPTION_CHANNELS_ALL;
+	}
+
 	// Call-backs:
 
 	// These are blank implementations, do not bother calling up to them.
@@ -163,4 +194,9 @@ namespace iosync
 	{
 		return;
 	}
+
+	void application::onNetworkPacketConfirmed(networkEngine&, packetID)
+	{
+		return;
+	}
 }
\ No newline at end of file
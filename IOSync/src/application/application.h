@@ -221,6 +221,9 @@ namespace iosync
 			// This method is abstract, and must be implemented.
 			virtual void update(rate localFrame=0) = 0;
 
+			// This is called at 'sampleRate', between updates; by default, nothing is sampled.
+			virtual void sample();
+
 			virtual nativeWindow getWindow() const;
 
 			inline frameNumber getFrame() const
@@ -237,6 +240,10 @@ namespace iosync
 			// This command may be used to virtually handle networking-messages from the perspective of an 'application'.
 			virtual bool parseNetworkMessage(QSocket& socket, const messageHeader& header, const messageFooter& footer);
 
+			// This retrieves the routing channels of a custom message, so servers may only relay it to subscribed players.
+			// The input may be read freely; its position is restored afterward. By default, messages aren't routed.
+			virtual subscriptionChannels getNetworkMessageChannels(QSocket& socket, const messageHeader& header);
+
 			// Call-backs:
 
 			/*
@@ -258,6 +265,9 @@ namespace iosync
 			// This is called when a network-engine is closed.
 			virtual void onNetworkClosed(networkEngine& engine);
 
+			// This is called once every recipient of a reliable packet has confirmed it.
+			virtual void onNetworkPacketConfirmed(networkEngine& engine, packetID ID);
+
 			// Fields (Public):
 
 			// This acts as our standard argument container.
@@ -269,6 +279,9 @@ namespace iosync
 			// Rates:
 			rate updateRate;
 
+			// The rate 'sample' is called at; this is ignored unless it's faster than 'updateRate'.
+			rate sampleRate = 0;
+
 			// Booleans / Flags:
 			bool isRunning;
 		protected:
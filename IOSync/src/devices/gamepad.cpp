@@ -7,6 +7,7 @@
 #include "../names.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 // Namespace(s):
 namespace iosync
@@ -15,6 +16,243 @@ namespace iosync
 	{
 		// Structures:
 
+		// analogConditioning:
+
+		// Constructor(s):
+		analogConditioning::analogConditioning(unsigned short deadzone, unsigned short hysteresis, unsigned char precision)
+			: deadzone(deadzone), hysteresis(hysteresis), precision(precision) { /* Nothing so far. */ }
+
+		// Methods:
+		long long analogConditioning::apply(long long value, long long previous, unsigned char maximumPrecision) const
+		{
+			// Anything inside of the deadzone is treated as "rest".
+			if (abs(value) <= (long long)deadzone)
+				return 0;
+
+			// Truncate the value (Toward zero) to the requested precision:
+			if (precision > 0 && precision < maximumPrecision)
+			{
+				auto step = (1LL << (maximumPrecision - precision));
+
+				value = ((value / step) * step);
+			}
+
+			// Ignore small changes, so values don't flicker between two steps.
+			if (previous != 0 && abs(value - previous) <= (long long)hysteresis)
+				return previous;
+
+			return value;
+		}
+
+		// gamepadConditioning:
+
+		// Constructor(s):
+		gamepadConditioning::gamepadConditioning(analogConditioning thumbs, analogConditioning triggers)
+		{
+			setThumbs(thumbs);
+			setTriggers(triggers);
+		}
+
+		// Methods:
+		void gamepadConditioning::setThumbs(const analogConditioning& thumbs)
+		{
+			for (unsigned char i = 0; i < GAMEPAD_FIELD_ANALOG_COUNT; i++)
+			{
+				if (!isTrigger((gamepadStateFields)(GAMEPAD_FIELD_ANALOG_FIRST + i)))
+				{
+					axes[i] = thumbs;
+				}
+			}
+
+			return;
+		}
+
+		void gamepadConditioning::setTriggers(const analogConditioning& triggers)
+		{
+			for (unsigned char i = 0; i < GAMEPAD_FIELD_ANALOG_COUNT; i++)
+			{
+				if (isTrigger((gamepadStateFields)(GAMEPAD_FIELD_ANALOG_FIRST + i)))
+				{
+					axes[i] = triggers;
+				}
+			}
+
+			return;
+		}
+
+		void gamepadConditioning::apply(gamepadState& state, const gamepadState& previous) const
+		{
+			for (unsigned char i = 0; i < GAMEPAD_FIELD_ANALOG_COUNT; i++)
+			{
+				auto field = (gamepadStateFields)(GAMEPAD_FIELD_ANALOG_FIRST + i);
+				auto maximumPrecision = (unsigned char)((isTrigger(field)) ? GAMEPAD_TRIGGER_BITS : GAMEPAD_THUMB_BITS);
+
+				state.setField(field, axes[i].apply(state.getField(field), previous.getField(field), maximumPrecision));
+			}
+
+			return;
+		}
+
+		// gamepadReconstruction:
+
+		// Constructor(s):
+		gamepadReconstruction::gamepadReconstruction(bool interpolation, milliseconds maximumExtrapolation, unsigned short maximumError)
+			: maximumExtrapolation(maximumExtrapolation), maximumError(maximumError), interpolation(interpolation) { /* Nothing so far. */ }
+
+		// Functions:
+		void gamepadReconstruction::interpolate(gamepadState& state, const gamepadState& from, const gamepadState& to, double progress)
+		{
+			state = from;
+
+			for (unsigned char i = 0; i < GAMEPAD_FIELD_ANALOG_COUNT; i++)
+			{
+				auto field = (gamepadStateFields)(GAMEPAD_FIELD_ANALOG_FIRST + i);
+
+				auto origin = (double)from.getField(field);
+				auto target = (double)to.getField(field);
+
+				state.setField(field, clampField(field, (long long)round(origin + ((target - origin) * progress))));
+			}
+
+			return;
+		}
+
+		long long gamepadReconstruction::clampField(gamepadStateFields field, long long value)
+		{
+			if (gamepadConditioning::isTrigger(field))
+				return max(0LL, min(value, (long long)UCHAR_MAX));
+
+			return max((long long)SHRT_MIN, min(value, (long long)SHRT_MAX));
+		}
+
+		// Methods:
+		long long gamepadReconstruction::errorBound(gamepadStateFields field) const
+		{
+			// Triggers have fewer bits than thumb-sticks, so the bound is scaled down to match.
+			if (gamepadConditioning::isTrigger(field))
+				return ((long long)maximumError >> (GAMEPAD_THUMB_BITS - GAMEPAD_TRIGGER_BITS));
+
+			return (long long)maximumError;
+		}
+
+		// gamepadButtonEdges:
+
+		// Methods:
+		void gamepadButtonEdges::readFrom(QSocket& socket)
+		{
+			// Local variable(s):
+			auto total = (size_t)networking::readVarint(socket);
+
+			count = 0;
+
+			for (size_t i = 0; i < total; i++)
+			{
+				gamepadButtonEdge edge;
+
+				edge.buttons = (unsigned int)networking::readVarint(socket);
+				edge.offset = (unsigned int)networking::readVarint(socket);
+
+				// Anything past our own limit is read, but not kept.
+				if (count < GAMEPAD_MAX_BUTTON_EDGES)
+				{
+					edges[count++] = edge;
+				}
+			}
+
+			return;
+		}
+
+		void gamepadButtonEdges::writeTo(QSocket& socket) const
+		{
+			networking::writeVarint(socket, count);
+
+			for (unsigned char i = 0; i < count; i++)
+			{
+				networking::writeVarint(socket, edges[i].buttons);
+				networking::writeVarint(socket, edges[i].offset);
+			}
+
+			return;
+		}
+
+		void gamepadButtonEdges::prepend(const gamepadButtonEdges& skipped, unsigned char first, unsigned int buttons)
+		{
+			// Local variable(s):
+			gamepadButtonEdge merged[(GAMEPAD_MAX_BUTTON_EDGES * 2) + 1];
+
+			size_t total = 0;
+
+			// The skipped state came before all of our transitions, so it's timed from the oldest of them.
+			auto origin = ((count > 0) ? edges[0].offset : 0);
+
+			for (auto i = first; i < skipped.count; i++)
+			{
+				merged[total++] = { skipped.edges[i].buttons, (unsigned int)min<unsigned long long>((unsigned long long)origin + skipped.edges[i].offset, UINT_MAX) };
+			}
+
+			merged[total++] = { buttons, origin };
+
+			copy(edges, (edges + count), (merged + total));
+
+			total += count;
+
+			// Like 'gamepadButtonCoalescer', the newest transitions are kept.
+			auto start = (total - min<size_t>(total, GAMEPAD_MAX_BUTTON_EDGES));
+
+			count = 0;
+
+			for (auto i = start; i < total; i++)
+			{
+				edges[count++] = merged[i];
+			}
+
+			return;
+		}
+
+		// gamepadButtonCoalescer:
+
+		// Methods:
+		bool gamepadButtonCoalescer::record(unsigned int buttons, unsigned long long time)
+		{
+			if (buttons == lastButtons)
+				return false;
+
+			// Make room by forgetting the oldest transition.
+			if (count == (GAMEPAD_MAX_BUTTON_EDGES + 1))
+			{
+				copy((this->buttons + 1), (this->buttons + count), this->buttons);
+				copy((times + 1), (times + count), times);
+
+				count--;
+			}
+
+			this->buttons[count] = buttons;
+			times[count] = time;
+
+			count++;
+
+			lastButtons = buttons;
+
+			return true;
+		}
+
+		void gamepadButtonCoalescer::flush(gamepadButtonEdges& edges_out)
+		{
+			edges_out.clear();
+
+			// The newest transition is described by the state itself.
+			for (size_t i = 0; (i + 1) < count; i++)
+			{
+				auto offset = (times[count - 1] - min(times[i], times[count - 1]));
+
+				edges_out.edges[edges_out.count++] = { buttons[i], (unsigned int)min<unsigned long long>(offset, UINT_MAX) };
+			}
+
+			count = 0;
+
+			return;
+		}
+
 		// gamepadState:
 
 		// Constructor(s):
@@ -50,6 +288,20 @@ namespace iosync
 
 					native.Gamepad.sThumbRX = socket.read<SHORT>();
 					native.Gamepad.sThumbRY = socket.read<SHORT>();
+				#else
+					// This matches the layout used by Windows, so states may be shared between platforms.
+					native.packetNumber = socket.read<uint32_t>();
+
+					native.buttons = socket.read<uint16_t>();
+
+					native.leftTrigger = socket.read<uint8_t>();
+					native.rightTrigger = socket.read<uint8_t>();
+
+					native.thumbLX = socket.read<int16_t>();
+					native.thumbLY = socket.read<int16_t>();
+
+					native.thumbRX = socket.read<int16_t>();
+					native.thumbRY = socket.read<int16_t>();
 				#endif
 			#endif
 
@@ -94,6 +346,19 @@ namespace iosync
 					
 					socket.write<SHORT>(native.Gamepad.sThumbRX);
 					socket.write<SHORT>(native.Gamepad.sThumbRY);
+				#else
+					socket.write<uint32_t>(native.packetNumber);
+
+					socket.write<uint16_t>((uint16_t)native.buttons);
+
+					socket.write<uint8_t>(native.leftTrigger);
+					socket.write<uint8_t>(native.rightTrigger);
+
+					socket.write<int16_t>(native.thumbLX);
+					socket.write<int16_t>(native.thumbLY);
+
+					socket.write<int16_t>(native.thumbRX);
+					socket.write<int16_t>(native.thumbRY);
 				#endif
 			#endif
 
@@ -116,101 +381,443 @@ namespace iosync
 			return;
 		}
 
-		// Classes:
+		void gamepadState::writeDeltaTo(QSocket& socket, const gamepadState& baseline) const
+		{
+			// Local variable(s):
+			unsigned char changedFields = 0;
 
-		// gamepad:
+			for (unsigned char field = 0; field < GAMEPAD_FIELD_COUNT; field++)
+			{
+				if (getField((gamepadStateFields)field) != baseline.getField((gamepadStateFields)field))
+				{
+					changedFields |= (1 << field);
+				}
+			}
 
-		// Global variable(s):
-		#ifdef PLATFORM_WINDOWS
-			HANDLE gamepad::sharedMemory = HANDLE();
-		#endif
+			socket.write<unsigned char>(changedFields);
 
-		#ifdef GAMEPAD_VJOY_ENABLED
-			vJoy::vJoyDriver gamepad::vJoyInfo = { vJoy::vJoyDriver::VJOY_UNDEFINED };
-		#endif
+			for (unsigned char field = 0; field < GAMEPAD_FIELD_COUNT; field++)
+			{
+				if ((changedFields & (1 << field)) == 0)
+					continue;
 
-		// Functions:
+				auto value = getField((gamepadStateFields)field);
+				auto base = baseline.getField((gamepadStateFields)field);
 
-		// Windows-specific extensions:
-		#ifdef PLATFORM_WINDOWS
-			bool gamepad::__winnt__injectLibrary(DWORD processID, CPUArchitecture process_Architecture)
-			{
-				// Nested functions/lambdas:
-				auto injectionStr = [&]() -> string
+				switch (field)
 				{
-					stringstream injectionStream;
-					injectionStream << "IGNORE " << XINPUT_INJECTION_ARGUMENT << " " << processID;
+					case GAMEPAD_FIELD_PACKET_NUMBER:
+						// Packet numbers only move forward, so we write the (Wrapping) distance.
+						networking::writeVarint(socket, (unsigned int)(value - base));
 
-					return injectionStream.str();
-				};
+						break;
+					case GAMEPAD_FIELD_BUTTONS:
+						// Write the buttons that changed.
+						networking::writeVarint(socket, (unsigned long long)(value ^ base));
 
-				if (processID == 0)
-					return false;
+						break;
+					default:
+						{
+							// Triggers and axes are written as "zig-zag" encoded deltas, so small movements stay small.
+							auto delta = (value - base);
 
-				switch (process_Architecture)
-				{
-					#if defined(PLATFORM_X86) || defined(PLATFORM_X64)
-						case x86:
-							#if defined(PLATFORM_X86)
-								return application::__winnt__injectLibrary(INJECTION_DLL_NAME_X86, processID);
-							#else
-								return process::startProcess(TEXT(EXECUTABLE_NAME_X86), injectionStr());
-							#endif
-						case x64:
-							#if defined(PLATFORM_X64)
-								return application::__winnt__injectLibrary(INJECTION_DLL_NAME_X64, processID);
-							#else
-								return process::startProcess(TEXT(EXECUTABLE_NAME_X64), injectionStr());
-							#endif
-					#elif defined(PLATFORM_ARM) || defined(PLATFORM_ARM64)
-						case ARM:
-							return application::__winnt__injectLibrary(INJECTION_DLL_NAME_ARM, processID);
-						case ARM64:
-							return application::__winnt__injectLibrary(INJECTION_DLL_NAME_ARM64, processID);
-					#endif
-				}
+							networking::writeVarint(socket, (((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63)));
+						}
 
-				// This architecture is unsupported.
-				return false;
+						break;
+				}
 			}
 
-			bool gamepad::__winnt__injectLibrary(DWORD processID)
+			// Write the relative frame-number to the output.
+			networking::writeVarint(socket, frame);
+
+			return;
+		}
+
+		void gamepadState::readDeltaFrom(QSocket& socket, const gamepadState& baseline)
+		{
+			// Local variable(s):
+			gamepadStateDelta delta;
+
+			delta.readFrom(socket);
+			delta.applyTo(*this, baseline);
+
+			return;
+		}
+
+		bool gamepadState::equivalent(const gamepadState& state) const
+		{
+			for (unsigned char field = GAMEPAD_FIELD_BUTTONS; field < GAMEPAD_FIELD_COUNT; field++)
 			{
-				if (processID == 0)
+				if (getField((gamepadStateFields)field) != state.getField((gamepadStateFields)field))
+				{
 					return false;
+				}
+			}
 
-				#if !defined(PLATFORM_ARM)
-					return __winnt__injectLibrary(processID, (process::process32bit(processID)) ? x86 : x64);
+			// Return the default response.
+			return true;
+		}
+
+		long long gamepadState::getField(gamepadStateFields field) const
+		{
+			switch (field)
+			{
+				#ifdef PLATFORM_WINDOWS
+					case GAMEPAD_FIELD_PACKET_NUMBER:
+						return native.dwPacketNumber;
+					case GAMEPAD_FIELD_BUTTONS:
+						return native.Gamepad.wButtons;
+					case GAMEPAD_FIELD_LEFT_TRIGGER:
+						return native.Gamepad.bLeftTrigger;
+					case GAMEPAD_FIELD_RIGHT_TRIGGER:
+						return native.Gamepad.bRightTrigger;
+					case GAMEPAD_FIELD_THUMB_LX:
+						return native.Gamepad.sThumbLX;
+					case GAMEPAD_FIELD_THUMB_LY:
+						return native.Gamepad.sThumbLY;
+					case GAMEPAD_FIELD_THUMB_RX:
+						return native.Gamepad.sThumbRX;
+					case GAMEPAD_FIELD_THUMB_RY:
+						return native.Gamepad.sThumbRY;
 				#else
-					return __winnt__injectLibrary(processID, (process::process32bit(processID)) ? ARM : ARM64)
+					case GAMEPAD_FIELD_PACKET_NUMBER:
+						return native.packetNumber;
+					case GAMEPAD_FIELD_BUTTONS:
+						return native.buttons;
+					case GAMEPAD_FIELD_LEFT_TRIGGER:
+						return native.leftTrigger;
+					case GAMEPAD_FIELD_RIGHT_TRIGGER:
+						return native.rightTrigger;
+					case GAMEPAD_FIELD_THUMB_LX:
+						return native.thumbLX;
+					case GAMEPAD_FIELD_THUMB_LY:
+						return native.thumbLY;
+					case GAMEPAD_FIELD_THUMB_RX:
+						return native.thumbRX;
+					case GAMEPAD_FIELD_THUMB_RY:
+						return native.thumbRY;
 				#endif
+				default:
+					break;
 			}
 
-			#ifdef GAMEPAD_VJOY_ENABLED
-				vJoy::vJoyDriver::vJoyDriverState gamepad::__winnt__vJoy__init()
-				{
-					// Call the main implementation. (Shared "driver" object)
-					return vJoyInfo.init();
-				}
+			// Return the default response.
+			return 0;
+		}
 
-				vJoy::vJoyDriver::vJoyDriverState gamepad::__winnt__vJoy__deinit()
-				{
-					// Call the main implementation. (Shared "driver" object)
-					return vJoyInfo.deinit();
-				}
+		void gamepadState::setField(gamepadStateFields field, long long value)
+		{
+			switch (field)
+			{
+				#ifdef PLATFORM_WINDOWS
+					case GAMEPAD_FIELD_PACKET_NUMBER:
+						native.dwPacketNumber = (DWORD)value; break;
+					case GAMEPAD_FIELD_BUTTONS:
+						native.Gamepad.wButtons = (WORD)value; break;
+					case GAMEPAD_FIELD_LEFT_TRIGGER:
+						native.Gamepad.bLeftTrigger = (BYTE)value; break;
+					case GAMEPAD_FIELD_RIGHT_TRIGGER:
+						native.Gamepad.bRightTrigger = (BYTE)value; break;
+					case GAMEPAD_FIELD_THUMB_LX:
+						native.Gamepad.sThumbLX = (SHORT)value; break;
+					case GAMEPAD_FIELD_THUMB_LY:
+						native.Gamepad.sThumbLY = (SHORT)value; break;
+					case GAMEPAD_FIELD_THUMB_RX:
+						native.Gamepad.sThumbRX = (SHORT)value; break;
+					case GAMEPAD_FIELD_THUMB_RY:
+						native.Gamepad.sThumbRY = (SHORT)value; break;
+				#else
+					case GAMEPAD_FIELD_PACKET_NUMBER:
+						native.packetNumber = (unsigned int)value; break;
+					case GAMEPAD_FIELD_BUTTONS:
+						native.buttons = (unsigned int)value; break;
+					case GAMEPAD_FIELD_LEFT_TRIGGER:
+						native.leftTrigger = (unsigned char)value; break;
+					case GAMEPAD_FIELD_RIGHT_TRIGGER:
+						native.rightTrigger = (unsigned char)value; break;
+					case GAMEPAD_FIELD_THUMB_LX:
+						native.thumbLX = (short)value; break;
+					case GAMEPAD_FIELD_THUMB_LY:
+						native.thumbLY = (short)value; break;
+					case GAMEPAD_FIELD_THUMB_RX:
+						native.thumbRX = (short)value; break;
+					case GAMEPAD_FIELD_THUMB_RY:
+						native.thumbRY = (short)value; break;
+				#endif
+				default:
+					break;
+			}
 
-				LONG gamepad::__winnt__vJoy__capAxis(const UINT vJoyID, const LONG value, const UINT axis, const UINT maximum_value)
-				{
-					#ifdef GAMEPAD_VJOY_SAFE
-						auto& device = vJoyInfo.getDevice(vJoyID);
-						auto axisInfo = device.getAxis(axis)->second;
+			return;
+		}
 
-						LONG axis_mid = ((axisInfo.max - axisInfo.min) / 2);
+		// gamepadStateDelta:
 
-						//return axis_mid + value;
-						//return axis_mid + max(axis_min, min(value, axis_max));
-						
-						float scalar = max(((float)axis_mid / (float)maximum_value), 1.0f);
+		// Methods:
+		void gamepadStateDelta::readFrom(QSocket& socket)
+		{
+			changedFields = socket.read<unsigned char>();
+
+			for (unsigned char field = 0; field < GAMEPAD_FIELD_COUNT; field++)
+			{
+				values[field] = ((changedFields & (1 << field)) != 0) ? networking::readVarint(socket) : 0;
+			}
+
+			// Read the relative frame-number from the input.
+			frame = (application::frameNumber)networking::readVarint(socket);
+
+			return;
+		}
+
+		void gamepadStateDelta::applyTo(gamepadState& state, const gamepadState& baseline) const
+		{
+			state.native = baseline.native;
+
+			for (unsigned char field = 0; field < GAMEPAD_FIELD_COUNT; field++)
+			{
+				if ((changedFields & (1 << field)) == 0)
+					continue;
+
+				auto base = baseline.getField((gamepadStateFields)field);
+				auto encoded = values[field];
+
+				switch (field)
+				{
+					case GAMEPAD_FIELD_PACKET_NUMBER:
+						state.setField((gamepadStateFields)field, (unsigned int)(base + (long long)encoded));
+
+						break;
+					case GAMEPAD_FIELD_BUTTONS:
+						state.setField((gamepadStateFields)field, (base ^ (long long)encoded));
+
+						break;
+					default:
+						state.setField((gamepadStateFields)field, (base + ((long long)(encoded >> 1) ^ -(long long)(encoded & 1))));
+
+						break;
+				}
+			}
+
+			state.frame = frame;
+
+			return;
+		}
+
+		// gamepadStateQueue:
+
+		// Constructor(s):
+		gamepadStateQueue::gamepadStateQueue()
+		{
+			clear();
+		}
+
+		// Methods:
+		bool gamepadStateQueue::push(const gamepadState& state, gamepadSequence sequence)
+		{
+			// Drop states we've already moved past:
+			if (hasPopped && (signed char)(sequence - lastPopped) <= 0)
+				return false;
+
+			if (count == 0)
+			{
+				head = sequence;
+				tail = sequence;
+			}
+			else if ((signed char)(sequence - head) < 0)
+			{
+				// This state is older than anything queued; make sure it fits before the newest state.
+				if ((gamepadSequence)(tail - sequence) > GAMEPAD_STATE_QUEUE_CAPACITY)
+					return false;
+
+				head = sequence;
+			}
+			else
+			{
+				auto slot = (sequence % GAMEPAD_STATE_QUEUE_CAPACITY);
+
+				// Check if we already have this state:
+				if (present[slot] && sequences[slot] == sequence)
+					return false;
+
+				// Make room for this state by dropping the oldest states:
+				while ((gamepadSequence)(sequence - head) >= GAMEPAD_STATE_QUEUE_CAPACITY)
+				{
+					pop();
+
+					if (count == 0)
+					{
+						head = sequence;
+						tail = sequence;
+
+						break;
+					}
+				}
+			}
+
+			auto slot = (sequence % GAMEPAD_STATE_QUEUE_CAPACITY);
+
+			states[slot] = state;
+			sequences[slot] = sequence;
+			present[slot] = true;
+
+			count++;
+
+			if ((signed char)(sequence - tail) >= 0)
+			{
+				tail = (gamepadSequence)(sequence + 1);
+			}
+
+			return true;
+		}
+
+		bool gamepadStateQueue::push(const gamepadState& state)
+		{
+			if (count == 0)
+			{
+				return push(state, (hasPopped) ? (gamepadSequence)(lastPopped + 1) : tail);
+			}
+
+			return push(state, tail);
+		}
+
+		void gamepadStateQueue::pop()
+		{
+			present[head % GAMEPAD_STATE_QUEUE_CAPACITY] = false;
+
+			lastPopped = head;
+			hasPopped = true;
+
+			count--;
+
+			head++;
+
+			// Skip over states we never received:
+			if (count > 0)
+			{
+				while (!present[head % GAMEPAD_STATE_QUEUE_CAPACITY])
+				{
+					head++;
+				}
+			}
+
+			return;
+		}
+
+		void gamepadStateQueue::clear()
+		{
+			for (auto& p : present)
+			{
+				p = false;
+			}
+
+			head = 0;
+			tail = 0;
+
+			count = 0;
+
+			hasPopped = false;
+
+			return;
+		}
+
+		// Classes:
+
+		// gamepad:
+
+		// Global variable(s):
+		gamepad::sharedGamepadMemory gamepad::sharedMemory = gamepad::sharedGamepadMemory(SHARED_GAMEPAD_MEMORY_NAME);
+
+		#ifdef GAMEPAD_VJOY_ENABLED
+			vJoy::vJoyDriver gamepad::vJoyInfo = { vJoy::vJoyDriver::VJOY_UNDEFINED };
+		#endif
+
+		#ifdef GAMEPAD_EVDEV_ENABLED
+			evdev::evdevDriver gamepad::evdevInfo;
+		#endif
+
+		// Functions:
+
+		// Windows-specific extensions:
+		#ifdef PLATFORM_WINDOWS
+			bool gamepad::__winnt__injectLibrary(DWORD processID, CPUArchitecture process_Architecture)
+			{
+				// Nested functions/lambdas:
+				auto injectionStr = [&]() -> string
+				{
+					stringstream injectionStream;
+					injectionStream << "IGNORE " << XINPUT_INJECTION_ARGUMENT << " " << processID;
+
+					return injectionStream.str();
+				};
+
+				if (processID == 0)
+					return false;
+
+				switch (process_Architecture)
+				{
+					#if defined(PLATFORM_X86) || defined(PLATFORM_X64)
+						case x86:
+							#if defined(PLATFORM_X86)
+								return application::__winnt__injectLibrary(INJECTION_DLL_NAME_X86, processID);
+							#else
+								return process::startProcess(TEXT(EXECUTABLE_NAME_X86), injectionStr());
+							#endif
+						case x64:
+							#if defined(PLATFORM_X64)
+								return application::__winnt__injectLibrary(INJECTION_DLL_NAME_X64, processID);
+							#else
+								return process::startProcess(TEXT(EXECUTABLE_NAME_X64), injectionStr());
+							#endif
+					#elif defined(PLATFORM_ARM) || defined(PLATFORM_ARM64)
+						case ARM:
+							return application::__winnt__injectLibrary(INJECTION_DLL_NAME_ARM, processID);
+						case ARM64:
+							return application::__winnt__injectLibrary(INJECTION_DLL_NAME_ARM64, processID);
+					#endif
+				}
+
+				// This architecture is unsupported.
+				return false;
+			}
+
+			bool gamepad::__winnt__injectLibrary(DWORD processID)
+			{
+				if (processID == 0)
+					return false;
+
+				#if !defined(PLATFORM_ARM)
+					return __winnt__injectLibrary(processID, (process::process32bit(processID)) ? x86 : x64);
+				#else
+					return __winnt__injectLibrary(processID, (process::process32bit(processID)) ? ARM : ARM64)
+				#endif
+			}
+
+			#ifdef GAMEPAD_VJOY_ENABLED
+				vJoy::vJoyDriver::vJoyDriverState gamepad::__winnt__vJoy__init()
+				{
+					// Call the main implementation. (Shared "driver" object)
+					return vJoyInfo.init();
+				}
+
+				vJoy::vJoyDriver::vJoyDriverState gamepad::__winnt__vJoy__deinit()
+				{
+					// Call the main implementation. (Shared "driver" object)
+					return vJoyInfo.deinit();
+				}
+
+				LONG gamepad::__winnt__vJoy__capAxis(const UINT vJoyID, const LONG value, const UINT axis, const UINT maximum_value)
+				{
+					#ifdef GAMEPAD_VJOY_SAFE
+						auto& device = vJoyInfo.getDevice(vJoyID);
+						auto axisInfo = device.getAxis(axis)->second;
+
+						LONG axis_mid = ((axisInfo.max - axisInfo.min) / 2);
+
+						//return axis_mid + value;
+						//return axis_mid + max(axis_min, min(value, axis_max));
+						
+						float scalar = max(((float)axis_mid / (float)maximum_value), 1.0f);
 
 						return max(axisInfo.min, min((axis_mid + ((LONG)((float)value * scalar))), axisInfo.max));
 					#else
@@ -349,20 +956,81 @@ namespace iosync
 			#endif
 		#endif
 
-		void gamepad::simulateState(const gamepadState& state, const gamepadID localIdentifier)
-		{
-			#ifdef PLATFORM_WINDOWS
-				if (__winnt__sharedMemoryOpen())
-				{
-					auto buffer = __winnt__map_States_Memory(FILE_MAP_WRITE);
+		// Linux-specific extensions:
+		#ifdef GAMEPAD_EVDEV_ENABLED
+			bool gamepad::__linux__realDeviceState(gamepadID identifier, nativeGamepad& state, timeval& timestamp_out)
+			{
+				// Local variable(s):
+				evdev::evdevReport report;
 
-					nativeGamepad* statePtr = (((nativeGamepad*)__winnt__sharedMemory_getStatesOffset(buffer)) + localIdentifier); // FILE_MAP_ALL_ACCESS
+				if (!evdevInfo.state((size_t)identifier, report))
+					return false;
 
-					*statePtr = state.native;
-					
-					__winnt__unmapSharedMemory(buffer);
+				state.packetNumber = report.packetNumber;
+
+				state.buttons = report.buttons;
+
+				state.leftTrigger = report.leftTrigger;
+				state.rightTrigger = report.rightTrigger;
+
+				state.thumbLX = report.thumbLX;
+				state.thumbLY = report.thumbLY;
+
+				state.thumbRX = report.thumbRX;
+				state.thumbRY = report.thumbRY;
+
+				timestamp_out = report.timestamp;
+
+				return true;
+			}
+
+			void gamepad::__linux__realDeviceEdges(gamepadID identifier, gamepadButtonCoalescer& coalescer)
+			{
+				// Local variable(s):
+				evdev::evdevButtonEdge edges[evdev::EVDEV_MAX_BUTTON_EDGES];
+
+				auto count = evdevInfo.takeEdges((size_t)identifier, edges, evdev::EVDEV_MAX_BUTTON_EDGES);
+
+				for (size_t i = 0; i < count; i++)
+				{
+					const auto& timestamp = edges[i].timestamp;
+
+					coalescer.record(edges[i].buttons, (((unsigned long long)timestamp.tv_sec * 1000000ULL) + (unsigned long long)timestamp.tv_usec));
 				}
-			#endif
+
+				return;
+			}
+		#endif
+
+		#ifdef GAMEPAD_UINPUT_ENABLED
+			bool gamepad::__linux__uinput__simulateState(const gamepadState& state, evdev::uinputGamepad& device)
+			{
+				// Local variable(s):
+				evdev::evdevReport report;
+
+				ZeroVariable(report);
+
+				report.packetNumber = state.native.packetNumber;
+
+				report.buttons = state.native.buttons;
+
+				report.leftTrigger = state.native.leftTrigger;
+				report.rightTrigger = state.native.rightTrigger;
+
+				report.thumbLX = state.native.thumbLX;
+				report.thumbLY = state.native.thumbLY;
+
+				report.thumbRX = state.native.thumbRX;
+				report.thumbRY = state.native.thumbRY;
+
+				return device.apply(report);
+			}
+		#endif
+
+		void gamepad::simulateState(const gamepadState& state, const gamepadID localIdentifier)
+		{
+			// The segment stays mapped, so this only publishes the state. (See 'sharedStateMemory::publish')
+			sharedMemory.publish((size_t)localIdentifier, state.native);
 
 			return;
 		}
@@ -375,7 +1043,11 @@ namespace iosync
 				, local_vJoyID(0)
 			#endif
 		{
-			// Nothing so far.
+			fill(begin(receivedSequences), end(receivedSequences), 0);
+			fill(begin(receivedValid), end(receivedValid), false);
+
+			fill(begin(extrapolatedValues), end(extrapolatedValues), 0.0);
+			fill(begin(extrapolationVelocity), end(extrapolationVelocity), 0.0);
 		}
 
 		// Destructor(s):
@@ -440,6 +1112,20 @@ namespace iosync
 					}
 				#endif
 
+				// Filter out analog noise; if nothing meaningful changed,
+				// keep the previous packet number, so this isn't treated as a new state.
+				conditioning.apply(state, localState);
+
+				if (state.equivalent(localState))
+				{
+					state.native.dwPacketNumber = localState.native.dwPacketNumber;
+				}
+				else
+				{
+					// XInput only reports the newest state, so transitions are timed by when we detect them.
+					buttonCoalescer.record(state.native.Gamepad.wButtons, (unsigned long long)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+				}
+
 				if (program.multiWayHost())
 				{
 					if (stateLog.empty())
@@ -460,23 +1146,99 @@ namespace iosync
 
 					previousFrameIn = currentFrame;
 
-					stateLog.push_back(state);
+					stateLog.push(state);
+				}
+
+				if (state.native.dwPacketNumber != localState.native.dwPacketNumber)
+				{
+					localStateTimestamp = (gamepadTimestamp)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
 				}
 
 				localState = state;
-			#endif
+			#elif defined(GAMEPAD_EVDEV_ENABLED)
+				if (program.multiWayHost())
+				{
+					if (!stateLog.empty())
+					{
+						__linux__lastPacketNumber = stateLog.back().native.packetNumber;
+					}
+				}
 
-			return;
-		}
+				gamepadState state = localState;
+				timeval timestamp;
+
+				// Read the newest complete report from the device.
+				if (!__linux__realDeviceState(localGamepadNumber, state.native, timestamp))
+				{
+					#ifdef GAMEPAD_DEBUG
+						deviceInfo << "Attempted to detect device that is not connected: " << (unsigned int)localGamepadNumber << endl;
+					#endif
 
-		void gamepad::simulate(iosync_application& program)
-		{
-			#ifdef PLATFORM_WINDOWS
-				if (!__winnt__sharedMemoryOpen())
 					return;
-			#endif
+				}
 
-			simulateState(program);
+				// Nothing has been reported since the last detection.
+				if (state.native.packetNumber == localState.native.packetNumber)
+				{
+					return;
+				}
+
+				// Collect every button transition since the last detection, including those the newest report no longer shows.
+				__linux__realDeviceEdges(localGamepadNumber, buttonCoalescer);
+
+				// Filter out analog noise; if nothing meaningful changed,
+				// keep the previous packet number, so this isn't treated as a new state.
+				// States hiding button transitions (Such as a quick press and release) are always new.
+				conditioning.apply(state, localState);
+
+				if (state.equivalent(localState) && !buttonCoalescer.pending())
+				{
+					state.native.packetNumber = localState.native.packetNumber;
+				}
+
+				if (program.multiWayHost())
+				{
+					if (stateLog.empty())
+					{
+						__linux__lastPacketNumber = state.native.packetNumber;
+					}
+					else
+					{
+						if (__linux__lastPacketNumber == state.native.packetNumber)
+						{
+							return;
+						}
+					}
+
+					auto currentFrame = program.getFrame();
+
+					state.frame = (currentFrame - previousFrameIn);
+
+					previousFrameIn = currentFrame;
+
+					stateLog.push(state);
+				}
+
+				if (state.native.packetNumber != localState.native.packetNumber)
+				{
+					// Use when the kernel produced this report; any delay before we read it is buffered for as well.
+					localStateTimestamp = (gamepadTimestamp)(((unsigned long long)timestamp.tv_sec * 1000) + ((unsigned long long)timestamp.tv_usec / 1000));
+				}
+
+				localState = state;
+			#endif
+
+			return;
+		}
+
+		void gamepad::simulate(iosync_application& program)
+		{
+			#ifdef PLATFORM_WINDOWS
+				if (!sharedMemoryOpen())
+					return;
+			#endif
+
+			simulateState(program);
 
 			return;
 		}
@@ -485,32 +1247,129 @@ namespace iosync
 		{
 			gamepadState state = gamepadState();
 
-			state.readFrom(socket);
-			
-			/*
-			if (state == this->state)
+			lastActivity = high_resolution_clock::now();
+			silenceReported = false;
+
+			// Read the sequence of this state, and the sequence of the state it was encoded against.
+			auto sequence = socket.read<gamepadSequence>();
+			auto baseline = socket.read<gamepadSequence>();
+
+			gamepadStateDelta delta;
+
+			delta.readFrom(socket);
+
+			// Read the button transitions that led to this state. (See 'gamepadButtonCoalescer')
+			state.edges.readFrom(socket);
+
+			// Read when the sender detected this state.
+			auto timestamp = socket.read<gamepadTimestamp>();
+			auto arrival = high_resolution_clock::now();
+
+			if (sequence == baseline)
 			{
-				return;
+				// This is a "keyframe"; it was encoded against an empty state.
+				delta.applyTo(state, gamepadState());
 			}
-			*/
-
-			auto validState = [this, state] ()
+			else if (hasReceived(baseline))
 			{
-				for (const auto& s : stateLog)
+				delta.applyTo(state, receivedStates[baseline % GAMEPAD_DELTA_HISTORY]);
+			}
+			else
+			{
+				/*
+					We haven't received this baseline yet; it may have been reordered, or resent.
+					(Or lost on its way through a relay, which can't confirm it for us)
+					Hold this state until the baseline arrives, rather than waiting for the next keyframe.
+				*/
+
+				gamepadPendingState pending;
+
+				pending.delta = delta;
+				pending.edges = state.edges;
+				pending.sequence = sequence;
+				pending.baseline = baseline;
+				pending.timestamp = timestamp;
+				pending.arrival = arrival;
+
+				pendingStates.push_back(pending);
+
+				// The oldest states are the least likely to be resolved.
+				while (pendingStates.size() > GAMEPAD_MAX_PENDING_STATES)
 				{
-					if (s >= state)
-					{
-						return false;
-					}
+					pendingStates.pop_front();
 				}
 
-				return true;
-			};
+				return;
+			}
+
+			acceptState(state, sequence, timestamp, arrival);
+
+			// This state may be the baseline of states we're holding.
+			resolvePendingStates();
+
+			return;
+		}
+
+		void gamepad::acceptState(const gamepadState& state, gamepadSequence sequence, gamepadTimestamp timestamp, high_resolution_clock::time_point arrival)
+		{
+			// Keep track of this state, so later states may be encoded against it.
+			auto slot = (sequence % GAMEPAD_DELTA_HISTORY);
+
+			receivedStates[slot] = state;
+			receivedSequences[slot] = sequence;
+			receivedValid[slot] = true;
+
+			if (!hasReceivedState || (signed char)(sequence - lastReceivedSequence) > 0)
+			{
+				lastReceivedSequence = sequence;
+				hasReceivedState = true;
+			}
 
-			//if (!contains(stateLog, state))
-			//if (validState())
+			// Queue this state by sequence; duplicates, and states we've already simulated past are dropped.
+			if (stateLog.push(state, sequence))
 			{
-				stateLog.push_back(state);
+				onStateArrived(timestamp, arrival);
+			}
+
+			return;
+		}
+
+		void gamepad::resolvePendingStates()
+		{
+			auto entry = pendingStates.begin();
+
+			while (entry != pendingStates.end())
+			{
+				auto baselineSlot = (entry->baseline % GAMEPAD_DELTA_HISTORY);
+
+				if (hasReceived(entry->baseline))
+				{
+					// Local variable(s):
+					gamepadState state;
+
+					state.edges = entry->edges;
+
+					entry->delta.applyTo(state, receivedStates[baselineSlot]);
+
+					auto pending = *entry;
+
+					pendingStates.erase(entry);
+
+					// Arrival is measured from when this state was received, rather than decoded.
+					acceptState(state, pending.sequence, pending.timestamp, pending.arrival);
+
+					// Accepting this state may have resolved others; start over.
+					entry = pendingStates.begin();
+				}
+				else if (receivedValid[baselineSlot] && (signed char)(receivedSequences[baselineSlot] - entry->baseline) > 0)
+				{
+					// The baseline's slot holds something newer, so it can no longer be decoded.
+					entry = pendingStates.erase(entry);
+				}
+				else
+				{
+					entry++;
+				}
 			}
 
 			return;
@@ -522,7 +1381,7 @@ namespace iosync
 			if (!stateLog.empty())
 			{
 				stateLog.front().writeTo(socket);
-				stateLog.pop_front();
+				stateLog.pop();
 			}
 			else
 			{
@@ -531,7 +1390,191 @@ namespace iosync
 			}
 			*/
 
-			localState.writeTo(socket);
+			// Local variable(s):
+			auto sequence = nextSequence++;
+
+			// Check if this state needs to be sent without a baseline:
+			bool keyframe = (!hasBaseline || statesSinceKeyframe >= GAMEPAD_KEYFRAME_INTERVAL || (gamepadSequence)(sequence - baselineSequence) >= GAMEPAD_DELTA_HISTORY);
+
+			socket.write<gamepadSequence>(sequence);
+
+			if (keyframe)
+			{
+				// Keyframes are marked by using their own sequence as the baseline.
+				socket.write<gamepadSequence>(sequence);
+
+				localState.writeDeltaTo(socket, gamepadState());
+
+				statesSinceKeyframe = 0;
+			}
+			else
+			{
+				socket.write<gamepadSequence>(baselineSequence);
+
+				localState.writeDeltaTo(socket, sentStates[baselineSequence % GAMEPAD_DELTA_HISTORY]);
+
+				statesSinceKeyframe++;
+			}
+
+			// Follow the state with the button transitions that led to it.
+			gamepadButtonEdges edges;
+
+			buttonCoalescer.flush(edges);
+
+			edges.writeTo(socket);
+
+			// Follow that with when the state was detected, so receivers may measure jitter. (See 'onStateArrived')
+			socket.write<gamepadTimestamp>(localStateTimestamp);
+
+			sentStates[sequence % GAMEPAD_DELTA_HISTORY] = localState;
+
+			lastSentSequence = sequence;
+			hasSentState = true;
+
+			// This state has been sent; wait for a new one before reporting a "real" state.
+			#if defined(PLATFORM_WINDOWS)
+				__winnt__lastPacketNumber = localState.native.dwPacketNumber;
+			#elif defined(GAMEPAD_EVDEV_ENABLED)
+				__linux__lastPacketNumber = localState.native.packetNumber;
+			#endif
+
+			return;
+		}
+
+		void gamepad::onStateSent(networking::packetID ID)
+		{
+			if (ID == networking::PACKET_ID_UNRELIABLE)
+				return;
+
+			unconfirmedStates.push_back(make_pair(ID, lastSentSequence));
+
+			// Packets that are never confirmed are eventually dropped by the network-engine, so we do the same:
+			while (unconfirmedStates.size() > GAMEPAD_DELTA_HISTORY)
+			{
+				unconfirmedStates.pop_front();
+			}
+
+			return;
+		}
+
+		bool gamepad::onPacketConfirmed(networking::packetID ID)
+		{
+			for (auto entry = unconfirmedStates.begin(); entry != unconfirmedStates.end(); entry++)
+			{
+				if (entry->first == ID)
+				{
+					// Only move the baseline forward; confirmations may arrive out of order.
+					if (!hasBaseline || (signed char)(entry->second - baselineSequence) > 0)
+					{
+						baselineSequence = entry->second;
+
+						hasBaseline = true;
+					}
+
+					// Anything older than this state is no longer useful as a baseline.
+					unconfirmedStates.erase(unconfirmedStates.begin(), ++entry);
+
+					return true;
+				}
+			}
+
+			// Return the default response.
+			return false;
+		}
+
+		void gamepad::onStateArrived(gamepadTimestamp timestamp, high_resolution_clock::time_point arrival)
+		{
+			// Local variable(s):
+			auto arrivalInterval = ((double)duration_cast<microseconds>(arrival - lastArrival).count() / 1000.0);
+
+			// The sender's timestamps wrap, so their distance is taken as signed; states may arrive out of order.
+			auto detectionInterval = (double)(short)(gamepadTimestamp)(timestamp - lastArrivalTimestamp);
+
+			lastArrival = arrival;
+			lastArrivalTimestamp = timestamp;
+
+			if (!hasArrival || abs(arrivalInterval) > (double)GAMEPAD_JITTER_MAXIMUM_GAP)
+			{
+				hasArrival = true;
+
+				return;
+			}
+
+			// The time between detections cancels out, leaving how much longer (Or shorter) this state took to arrive.
+			arrivalJitter += ((abs(arrivalInterval - detectionInterval) - arrivalJitter) / GAMEPAD_JITTER_SMOOTHING);
+
+			return;
+		}
+
+		size_t gamepad::targetDepth(const iosync_application& program) const
+		{
+			// Local variable(s):
+			auto framePeriod = (1000.0 / (double)max<rate>(program.updateRate, 1));
+
+			// Buffer enough states to cover twice the average jitter, plus the state being simulated.
+			auto depth = ((size_t)ceil((arrivalJitter * 2.0) / framePeriod) + 1);
+			auto maximumDepth = max<size_t>((size_t)((double)maximumLatency.count() / framePeriod), 1);
+
+			return min(depth, maximumDepth);
+		}
+
+		void gamepad::resetBaseline()
+		{
+			hasBaseline = false;
+
+			unconfirmedStates.clear();
+
+			return;
+		}
+
+		void gamepad::writeHeartbeatTo(QSocket& socket)
+		{
+			socket.writeBool(hasSentState);
+
+			if (hasSentState)
+			{
+				socket.write<gamepadSequence>(lastSentSequence);
+
+				sentStates[lastSentSequence % GAMEPAD_DELTA_HISTORY].writeDeltaTo(socket, gamepadState());
+			}
+
+			return;
+		}
+
+		void gamepad::readHeartbeatFrom(QSocket& socket)
+		{
+			lastActivity = high_resolution_clock::now();
+			silenceReported = false;
+
+			if (!socket.readBool())
+				return;
+
+			// Local variable(s):
+			auto sequence = socket.read<gamepadSequence>();
+
+			gamepadState state;
+
+			state.readDeltaFrom(socket, gamepadState());
+
+			// Check if we already have this state, or something newer:
+			if (hasReceivedState && (signed char)(sequence - lastReceivedSequence) <= 0)
+				return;
+
+			deviceInfo << "Recovered a lost gamepad state from a heartbeat." << endl;
+
+			auto slot = (sequence % GAMEPAD_DELTA_HISTORY);
+
+			receivedStates[slot] = state;
+			receivedSequences[slot] = sequence;
+			receivedValid[slot] = true;
+
+			lastReceivedSequence = sequence;
+			hasReceivedState = true;
+
+			stateLog.push(state, sequence);
+
+			// States held for this baseline may be decoded now.
+			resolvePendingStates();
 
 			return;
 		}
@@ -544,26 +1587,107 @@ namespace iosync
 			*/
 
 			if (stateLog.empty()) // if (!hasStates())
-				return false;
+			{
+				// We've run out of states; cover the gap, if we're allowed to.
+				return extrapolateState(program);
+			}
+
+			// Local variable(s):
+			auto target = targetDepth(program);
 
-			sort
-			(
-				stateLog.begin(), stateLog.end(),
-				[] (const gamepadState& X, const gamepadState& Y)
+			// After a spike, skip the stale states past our target, rather than replaying them late:
+			bool catchingUp = (stateLog.size() > (target + GAMEPAD_CATCH_UP_MARGIN));
+
+			if (catchingUp)
+			{
+				while (stateLog.size() > target)
 				{
-					return (X > Y);
+					// Local variable(s):
+					auto skipped = stateLog.front();
+
+					stateLog.pop();
+
+					// The button transitions of skipped states are still replayed, ahead of the next state.
+					stateLog.front().edges.prepend(skipped.edges, replayedEdges, (unsigned int)skipped.getField(GAMEPAD_FIELD_BUTTONS));
+
+					replayedEdges = 0;
 				}
-			);
+			}
 
+			// States are queued in order, so the oldest is always at the front.
 			gamepadState& state = stateLog.front();
 
 			auto currentFrame = program.getFrame();
 
-			if ((currentFrame-previousFrameOut) < state.frame)
+			// States are normally paced by their relative frames; this is skipped while catching up.
+			bool due = (catchingUp || (currentFrame-previousFrameOut) >= state.frame);
+
+			// Replay the button transitions that led to this state first, one per frame, so each of them is seen:
+			if (replayedEdges < state.edges.count && currentFrame != reconstructedFrame)
 			{
-				return false;
+				// Local variable(s):
+				const auto& edge = state.edges.edges[replayedEdges];
+
+				auto framePeriod = (1000000.0 / (double)max<rate>(program.updateRate, 1));
+				auto framesLeft = ((due) ? 0 : (state.frame - (currentFrame-previousFrameOut)));
+
+				// Transitions are timed relative to the state, so they're replayed as far ahead of it as they happened.
+				if (due || (application::frameNumber)((double)edge.offset / framePeriod) >= framesLeft)
+				{
+					auto edgeState = lastOutputState;
+
+					edgeState.setField(GAMEPAD_FIELD_BUTTONS, edge.buttons);
+
+					outputState(edgeState);
+
+					reconstructedFrame = currentFrame;
+					replayedEdges++;
+
+					return true;
+				}
+			}
+
+			if (!due)
+			{
+				// Until this state is due, move the analog inputs toward it.
+				return interpolateState(program, state);
 			}
 
+			outputState(state);
+
+			#ifdef PLATFORM_WINDOWS
+				__winnt__lastPacketNumber = state.native.dwPacketNumber;
+			#elif defined(GAMEPAD_UINPUT_ENABLED)
+				__linux__lastPacketNumber = state.native.packetNumber;
+			#endif
+
+			// Keep track of where the analog inputs are heading, in case we need to extrapolate.
+			priorSimulatedState = ((hasSimulatedState) ? lastSimulatedState : state);
+			lastSimulatedState = state;
+
+			hasSimulatedState = true;
+			extrapolating = false;
+			extrapolationExpired = false;
+
+			// Set the previous frame to the current state's frame.
+			previousFrameOut = currentFrame;
+			reconstructedFrame = currentFrame;
+
+			stateLog.pop();
+
+			replayedEdges = 0;
+
+			// Return the default response.
+			return true;
+		}
+
+		void gamepad::outputState(gamepadState state)
+		{
+			lastOutputState = state;
+
+			// Every state gets a new packet number, so reconstructed states aren't mistaken for the last one.
+			state.setField(GAMEPAD_FIELD_PACKET_NUMBER, (long long)(++outputPacketNumber));
+
 			simulateState(state, localGamepadNumber);
 
 			#ifdef PLATFORM_WINDOWS
@@ -588,16 +1712,119 @@ namespace iosync
 						}
 					}
 				#endif
-					
-				__winnt__lastPacketNumber = state.native.dwPacketNumber;
+			#elif defined(GAMEPAD_UINPUT_ENABLED)
+				if (__linux__uinputDevice.created())
+				{
+					__linux__uinput__simulateState(state, __linux__uinputDevice);
+				}
 			#endif
 
-			// Set the previous frame to the current state's frame.
-			previousFrameOut = currentFrame;
+			return;
+		}
+
+		bool gamepad::interpolateState(iosync_application& program, const gamepadState& next)
+		{
+			if (!reconstruction.interpolation || !hasSimulatedState || next.frame == 0)
+				return false;
 
-			stateLog.pop_front();
+			// Local variable(s):
+			auto currentFrame = program.getFrame();
+
+			// Only one state is simulated per frame.
+			if (currentFrame == reconstructedFrame)
+				return false;
+
+			auto progress = ((double)(currentFrame - previousFrameOut) / (double)next.frame);
+
+			gamepadState state;
+
+			gamepadReconstruction::interpolate(state, lastSimulatedState, next, progress);
+
+			// Keep any button transition we've replayed since.
+			state.setField(GAMEPAD_FIELD_BUTTONS, lastOutputState.getField(GAMEPAD_FIELD_BUTTONS));
+
+			reconstructedFrame = currentFrame;
+
+			// Nothing moved, so there's nothing new to simulate.
+			if (state.equivalent(lastOutputState))
+				return false;
+
+			outputState(state);
+
+			return true;
+		}
+
+		bool gamepad::extrapolateState(iosync_application& program)
+		{
+			if (!canExtrapolate())
+				return false;
+
+			// Local variable(s):
+			auto currentFrame = program.getFrame();
+
+			if (!extrapolating)
+			{
+				// Continue from the last state we received, along the path it took from the state before it.
+				auto frames = (double)max<application::frameNumber>(lastSimulatedState.frame, 1);
+
+				for (unsigned char i = 0; i < GAMEPAD_FIELD_ANALOG_COUNT; i++)
+				{
+					auto field = (gamepadStateFields)(GAMEPAD_FIELD_ANALOG_FIRST + i);
+
+					extrapolatedValues[i] = (double)lastSimulatedState.getField(field);
+					extrapolationVelocity[i] = ((extrapolatedValues[i] - (double)priorSimulatedState.getField(field)) / frames);
+				}
+
+				underrunSnapshot = high_resolution_clock::now();
+				reconstructedFrame = previousFrameOut;
+
+				extrapolating = true;
+			}
+
+			// Past our time limit, the last state is held, and buffering starts over.
+			if (elapsed(underrunSnapshot) >= reconstruction.maximumExtrapolation)
+			{
+				extrapolating = false;
+				extrapolationExpired = true;
+
+				return false;
+			}
+
+			if (currentFrame == reconstructedFrame)
+				return false;
+
+			// Local variable(s):
+			auto state = lastOutputState;
+
+			// The velocity decays with every frame; this steps through the frames since the last reconstructed state at once.
+			auto decay = ((double)GAMEPAD_EXTRAPOLATION_DECAY / 100.0);
+			auto decayed = pow(decay, (double)(currentFrame - reconstructedFrame));
+
+			reconstructedFrame = currentFrame;
+
+			for (unsigned char i = 0; i < GAMEPAD_FIELD_ANALOG_COUNT; i++)
+			{
+				auto field = (gamepadStateFields)(GAMEPAD_FIELD_ANALOG_FIRST + i);
+
+				// The sum of each frame's decayed velocity.
+				extrapolatedValues[i] += (extrapolationVelocity[i] * ((decay * (1.0 - decayed)) / (1.0 - decay)));
+				extrapolationVelocity[i] *= decayed;
+
+				// Never stray further than our error bound from the last state received.
+				auto origin = lastSimulatedState.getField(field);
+				auto bound = reconstruction.errorBound(field);
+
+				auto value = (long long)round(extrapolatedValues[i]);
+
+				state.setField(field, gamepadReconstruction::clampField(field, max((origin - bound), min(value, (origin + bound)))));
+			}
+
+			// Once the velocity has decayed, there's nothing new to simulate.
+			if (state.equivalent(lastOutputState))
+				return false;
+
+			outputState(state);
 
-			// Return the default response.
 			return true;
 		}
 
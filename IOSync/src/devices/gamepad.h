@@ -21,12 +21,21 @@
 #include "../application/application.h"
 
 #include "devices.h"
+#include "sharedMemory.h"
 
 #ifdef PLATFORM_WINDOWS
 	// vJoy functionality.
 	#include "native/winnt/vJoyDriver.h"
 #endif
 
+#ifdef PLATFORM_LINUX
+	// evdev functionality.
+	#include "native/linux/evdevDriver.h"
+
+	// uinput functionality.
+	#include "native/linux/uinputDriver.h"
+#endif
+
 // Standard library:
 #include <thread>
 #include <chrono>
@@ -89,6 +98,8 @@ namespace iosync
 			//#ifdef PLATFORM_LINUX
 			typedef struct virtual_nativeGamepad
 			{
+				unsigned int	packetNumber;
+
 				unsigned int	buttons; // unsigned short
 				unsigned char	leftTrigger;
 				unsigned char	rightTrigger;
@@ -105,6 +116,12 @@ namespace iosync
 
 		typedef unsigned char serializedGamepadID;
 
+		// Used to identify states for delta-encoding; this is expected to wrap.
+		typedef unsigned char gamepadSequence;
+
+		// When a state was detected, in milliseconds, using the sender's clock; this is expected to wrap.
+		typedef unsigned short gamepadTimestamp;
+
 		// Enumerator(s):
 		enum gamepadIDs : gamepadID
 		{
@@ -112,13 +129,17 @@ namespace iosync
 			SECOND_PLAYER,
 			THIRD_PLAYER,
 			FOURTH_PLAYER,
-			GAMEPAD_ID_NONE,
+
+			// Identifiers are serialized as a single byte; this leaves room for large device tables. (See 'gamepadTable')
+			GAMEPAD_ID_NONE = UCHAR_MAX,
 		};
 
 		enum metrics : unsigned long long
 		{
-			#ifdef PLATFORM_WINDOWS
+			#if defined(PLATFORM_WINDOWS)
 				MAX_GAMEPADS = 4,
+			#elif defined(GAMEPAD_EVDEV_ENABLED)
+				MAX_GAMEPADS = evdev::MAX_EVDEV_DEVICES,
 			#else
 				MAX_GAMEPADS = 1, // 0,
 			#endif
@@ -130,14 +151,96 @@ namespace iosync
 			#endif
 		};
 
-		#ifdef PLATFORM_WINDOWS
-			enum sharedMemoryState
-			{
-				SHARED_MEMORY_UNAVAILABLE,
-				SHARED_MEMORY_ALREADY_ALLOCATED,
-				SHARED_MEMORY_ALLOCATED,
-			};
-		#endif
+		// Delta-encoding related:
+		enum gamepadDeltaMetrics : unsigned int
+		{
+			// The number of sent (And received) states remembered for delta-encoding.
+			// This must be a factor of the range of 'gamepadSequence'.
+			GAMEPAD_DELTA_HISTORY = 32,
+
+			// The maximum number of states sent between "keyframes". (States encoded without a baseline)
+			GAMEPAD_KEYFRAME_INTERVAL = 60,
+
+			// The most received states which may wait for their baselines to arrive. (See 'gamepad::readFrom')
+			GAMEPAD_MAX_PENDING_STATES = 16,
+
+			// The number of received states which may wait to be simulated. (See 'gamepadStateQueue')
+			// This must be a factor of the range of 'gamepadSequence', and no more than half of it.
+			GAMEPAD_STATE_QUEUE_CAPACITY = 64,
+		};
+
+		// The fields of a 'gamepadState' which may be delta-encoded.
+		// These are used as bit-indices in the changed-field mask.
+		enum gamepadStateFields : unsigned char
+		{
+			GAMEPAD_FIELD_PACKET_NUMBER,
+			GAMEPAD_FIELD_BUTTONS,
+			GAMEPAD_FIELD_LEFT_TRIGGER,
+			GAMEPAD_FIELD_RIGHT_TRIGGER,
+			GAMEPAD_FIELD_THUMB_LX,
+			GAMEPAD_FIELD_THUMB_LY,
+			GAMEPAD_FIELD_THUMB_RX,
+			GAMEPAD_FIELD_THUMB_RY,
+
+			GAMEPAD_FIELD_COUNT,
+
+			// The analog fields, in order:
+			GAMEPAD_FIELD_ANALOG_FIRST = GAMEPAD_FIELD_LEFT_TRIGGER,
+			GAMEPAD_FIELD_ANALOG_COUNT = (GAMEPAD_FIELD_COUNT - GAMEPAD_FIELD_ANALOG_FIRST),
+		};
+
+		// Analog conditioning related:
+		enum gamepadConditioningMetrics : unsigned short
+		{
+			// The number of meaningful bits each type of analog input has.
+			GAMEPAD_THUMB_BITS = 16,
+			GAMEPAD_TRIGGER_BITS = 8,
+
+			// Defaults (Measured in raw units, other than precision, which is in bits):
+			DEFAULT_GAMEPAD_THUMB_DEADZONE = 2048,
+			DEFAULT_GAMEPAD_THUMB_HYSTERESIS = 256,
+			DEFAULT_GAMEPAD_THUMB_PRECISION = 12,
+
+			DEFAULT_GAMEPAD_TRIGGER_DEADZONE = 8,
+			DEFAULT_GAMEPAD_TRIGGER_HYSTERESIS = 2,
+			DEFAULT_GAMEPAD_TRIGGER_PRECISION = GAMEPAD_TRIGGER_BITS,
+		};
+
+		// Jitter buffering related:
+		enum gamepadJitterMetrics : unsigned int
+		{
+			// The most latency buffering adds by default, in milliseconds.
+			DEFAULT_GAMEPAD_MAXIMUM_LATENCY = 100,
+
+			// Arrival statistics are averaged over roughly this many states.
+			GAMEPAD_JITTER_SMOOTHING = 16,
+
+			// States arriving further apart than this (In milliseconds) aren't compared; timestamps wrap after about a minute.
+			GAMEPAD_JITTER_MAXIMUM_GAP = 30000,
+
+			// Queued states are only skipped once there are this many more than we buffer for.
+			GAMEPAD_CATCH_UP_MARGIN = 2,
+		};
+
+		// Analog reconstruction related:
+		enum gamepadReconstructionMetrics : unsigned int
+		{
+			// The longest a gamepad may be extrapolated for by default, in milliseconds.
+			DEFAULT_GAMEPAD_MAXIMUM_EXTRAPOLATION = 50,
+
+			// The furthest a thumb-stick may be extrapolated from the last received state by default. (In raw units; triggers are scaled)
+			DEFAULT_GAMEPAD_EXTRAPOLATION_ERROR = 4096,
+
+			// The percentage of an axis' velocity kept with each extrapolated frame.
+			GAMEPAD_EXTRAPOLATION_DECAY = 75,
+		};
+
+		// Button coalescing related:
+		enum gamepadCoalescingMetrics : unsigned int
+		{
+			// The most button transitions carried with a single state; the oldest are dropped past this.
+			GAMEPAD_MAX_BUTTON_EDGES = 8,
+		};
 
 		// Constant variable(s):
 		static const size_t serializedNativeGamepadSize = sizeof(nativeGamepad); // sizeof(nativeGamepad);
@@ -146,28 +249,199 @@ namespace iosync
 			const string XINPUT_INJECTION_ARGUMENT = "XI_INJECT";
 			const wstring XINPUT_INJECTION_ARGUMENTW = L"XI_INJECT";
 			
-			static LPCTSTR SHARED_GAMEPAD_MEMORY_NAME = "IOSYNC_GAMEPAD_BUFFER";
+		#endif
 
-			static const size_t SHARED_SIZEOF_PLUGGED_IN_SEGMENT = (sizeof(bool)*MAX_GAMEPADS);
-			static const size_t SHARED_SIZEOF_GAMEPAD_STATES = (sizeof(nativeGamepad)*MAX_GAMEPADS);
+		// The name of the shared memory segment simulated gamepads are published to. (See 'gamepad::sharedMemory')
+		#ifdef PLATFORM_WINDOWS
+			static const char* SHARED_GAMEPAD_MEMORY_NAME = "IOSYNC_GAMEPAD_BUFFER";
+		#else
+			static const char* SHARED_GAMEPAD_MEMORY_NAME = "/IOSYNC_GAMEPAD_BUFFER";
+		#endif
 
-			// The position where the "plugged in" segment begins.
-			static const size_t SHARED_GAMEPAD_MEMORY_PLUGGED_IN_OFFSET = 0;
+		// Structures:
 
-			// The position where the "states" segment begins.
-			static const size_t SHARED_GAMEPAD_MEMORY_STATES_OFFSET = SHARED_SIZEOF_PLUGGED_IN_SEGMENT;
+		// This describes how a single analog input is filtered before being considered "new".
+		struct analogConditioning
+		{
+			// Constructor(s):
+			analogConditioning(unsigned short deadzone=0, unsigned short hysteresis=0, unsigned char precision=GAMEPAD_THUMB_BITS);
 
-			// The position where the "plugged in" segment ends.
-			static const size_t SHARED_GAMEPAD_MEMORY_PLUGGED_IN_MAX_SCOPE = SHARED_GAMEPAD_MEMORY_PLUGGED_IN_OFFSET+SHARED_SIZEOF_PLUGGED_IN_SEGMENT;
+			// Methods:
 
-			// The position where the "states" segment ends.
-			static const size_t SHARED_GAMEPAD_MEMORY_STATES_MAX_SCOPE = SHARED_GAMEPAD_MEMORY_STATES_OFFSET+SHARED_SIZEOF_GAMEPAD_STATES;
+			/*
+				This filters 'value', using 'previous' as the last value that was accepted.
+				Values within the deadzone become zero, values are truncated to 'precision' bits,
+				and changes no larger than 'hysteresis' keep the previous value.
+			*/
 
-			// The size of the shared memory area.
-			static const DWORD SHARED_GAMEPAD_MEMORY_SIZE = (SHARED_SIZEOF_PLUGGED_IN_SEGMENT+SHARED_SIZEOF_GAMEPAD_STATES);
-		#endif
+			long long apply(long long value, long long previous, unsigned char maximumPrecision) const;
+
+			// Fields:
+			unsigned short deadzone;
+			unsigned short hysteresis;
+
+			// The number of bits kept. (Values at or above the input's own precision disable quantization)
+			unsigned char precision;
+		};
+
+		// This conditions the analog inputs of a 'gamepadState', so sensor noise doesn't produce new states.
+		struct gamepadConditioning
+		{
+			// Constructor(s):
+			gamepadConditioning
+			(
+				analogConditioning thumbs=analogConditioning(DEFAULT_GAMEPAD_THUMB_DEADZONE, DEFAULT_GAMEPAD_THUMB_HYSTERESIS, DEFAULT_GAMEPAD_THUMB_PRECISION),
+				analogConditioning triggers=analogConditioning(DEFAULT_GAMEPAD_TRIGGER_DEADZONE, DEFAULT_GAMEPAD_TRIGGER_HYSTERESIS, DEFAULT_GAMEPAD_TRIGGER_PRECISION)
+			);
+
+			// Methods:
+			void setThumbs(const analogConditioning& thumbs);
+			void setTriggers(const analogConditioning& triggers);
+
+			// This conditions the analog inputs of 'state', relative to the last accepted state.
+			void apply(gamepadState& state, const gamepadState& previous) const;
+
+			static inline bool isTrigger(gamepadStateFields field)
+			{
+				return (field == GAMEPAD_FIELD_LEFT_TRIGGER || field == GAMEPAD_FIELD_RIGHT_TRIGGER);
+			}
+
+			// Fields:
+
+			// Per-axis settings, indexed from 'GAMEPAD_FIELD_ANALOG_FIRST'.
+			analogConditioning axes[GAMEPAD_FIELD_ANALOG_COUNT];
+		};
+
+		/*
+			This describes how the analog inputs of a simulated gamepad are reconstructed between received states.
+
+			While the next state isn't due, the sticks and triggers are interpolated toward it,
+			so states sent at a low rate don't move in steps. When no states are buffered, the
+			analog inputs continue along their last velocity, which decays every frame, for up to
+			'maximumExtrapolation'; extrapolated values never stray further than 'maximumError'
+			from the last state received. Buttons are never reconstructed.
+		*/
+
+		struct gamepadReconstruction
+		{
+			// Constructor(s):
+			gamepadReconstruction
+			(
+				bool interpolation=true,
+				milliseconds maximumExtrapolation=(milliseconds)DEFAULT_GAMEPAD_MAXIMUM_EXTRAPOLATION,
+				unsigned short maximumError=DEFAULT_GAMEPAD_EXTRAPOLATION_ERROR
+			);
+
+			// Functions:
+
+			// This blends the analog inputs of 'from' toward 'to' by 'progress'. (0.0 to 1.0; everything else is kept from 'from')
+			static void interpolate(gamepadState& state, const gamepadState& from, const gamepadState& to, double progress);
+
+			// This clamps 'value' to the range of the analog input 'field'.
+			static long long clampField(gamepadStateFields field, long long value);
+
+			// Methods:
+
+			// The furthest 'field' may be extrapolated from the last state received.
+			long long errorBound(gamepadStateFields field) const;
+
+			inline bool canExtrapolate() const
+			{
+				return (maximumExtrapolation.count() > 0 && maximumError > 0);
+			}
+
+			// Fields:
+			milliseconds maximumExtrapolation;
+
+			// Measured in raw thumb-stick units.
+			unsigned short maximumError;
+
+			// Booleans / Flags:
+			bool interpolation;
+		};
+
+		// A button transition carried with a state.
+		struct gamepadButtonEdge
+		{
+			// The buttons held after this transition.
+			unsigned int buttons;
+
+			// How long before the newest transition this happened. (In microseconds)
+			unsigned int offset;
+		};
+
+		/*
+			These are the button transitions which happened between two sent states, oldest first.
+
+			The newest transition isn't included, as the state carrying these already describes it.
+			Receivers replay each transition before the state itself, so presses which were
+			released before the state was sent still reach the simulated device.
+		*/
+
+		struct gamepadButtonEdges
+		{
+			// Methods:
+			void readFrom(QSocket& socket);
+			void writeTo(QSocket& socket) const;
+
+			// This places the transitions of a skipped state, starting with 'first', ahead of these,
+			// followed by the 'buttons' that state held. If there are too many, the oldest are dropped.
+			void prepend(const gamepadButtonEdges& skipped, unsigned char first, unsigned int buttons);
+
+			inline void clear()
+			{
+				count = 0;
+
+				return;
+			}
+
+			inline bool empty() const
+			{
+				return (count == 0);
+			}
+
+			// Fields:
+			gamepadButtonEdge edges[GAMEPAD_MAX_BUTTON_EDGES];
+
+			unsigned char count = 0;
+		};
+
+		/*
+			This collects the buttons detected between sent states, so sending less often doesn't lose quick presses.
+
+			Only transitions are kept, along with when they happened. When a state is sent, every
+			transition before the newest is handed to it, timed relative to the newest. (See 'gamepadButtonEdges')
+		*/
+
+		struct gamepadButtonCoalescer
+		{
+			// Methods:
+
+			// This records the buttons held at 'time'. (In microseconds; 'steady_clock' based)
+			// The return value of this command indicates if the buttons changed.
+			bool record(unsigned int buttons, unsigned long long time);
+
+			// This outputs every transition before the newest, then forgets them.
+			void flush(gamepadButtonEdges& edges_out);
+
+			// This specifies if transitions would be lost by only sending the newest buttons.
+			inline bool pending() const
+			{
+				return (count > 1);
+			}
+
+			// Fields:
+
+			// Every transition since the last flush, oldest first; the last entry is the newest.
+			unsigned int buttons[GAMEPAD_MAX_BUTTON_EDGES + 1];
+			unsigned long long times[GAMEPAD_MAX_BUTTON_EDGES + 1];
+
+			size_t count = 0;
+
+			// The buttons held after the newest transition.
+			unsigned int lastButtons = 0;
+		};
 
-		// Structures:
 		struct gamepadState
 		{
 			// Constant variable(s):
@@ -189,6 +463,21 @@ namespace iosync
 			void readFrom(QSocket& socket);
 			void writeTo(QSocket& socket);
 
+			// Delta-encoding:
+
+			// This writes a changed-field mask, followed by the fields that differ from 'baseline'.
+			// Axes are written as small signed deltas, and buttons as the bits that changed.
+			void writeDeltaTo(QSocket& socket, const gamepadState& baseline) const;
+
+			// This reads a state written by 'writeDeltaTo', using the same 'baseline'.
+			void readDeltaFrom(QSocket& socket, const gamepadState& baseline);
+
+			long long getField(gamepadStateFields field) const;
+			void setField(gamepadStateFields field, long long value);
+
+			// This specifies if 'state' describes the same input. (Packet numbers and frames are ignored)
+			bool equivalent(const gamepadState& state) const;
+
 			// Operators (Only works per-gamepad; uses native packet IDs):
 			inline bool operator==(const gamepadState& state) const
 			{
@@ -197,8 +486,10 @@ namespace iosync
 					return false;
 				*/
 
-				#ifdef PLATFORM_WINDOWS
+				#if defined(PLATFORM_WINDOWS)
 					return (native.dwPacketNumber == state.native.dwPacketNumber);
+				#elif defined(GAMEPAD_EVDEV_ENABLED)
+					return (native.packetNumber == state.native.packetNumber);
 				#else
 					return false;
 				#endif
@@ -235,21 +526,132 @@ namespace iosync
 			// Fields:
 			application::frameNumber frame;
 			nativeGamepad native;
+
+			// The button transitions which led to this state. (Only used for received states)
+			gamepadButtonEdges edges;
+		};
+
+		// A state written by 'gamepadState::writeDeltaTo', kept as it was encoded; this lets it wait for its baseline.
+		struct gamepadStateDelta
+		{
+			// Methods:
+			void readFrom(QSocket& socket);
+
+			// This rebuilds the state described by this delta, using the baseline it was encoded against.
+			void applyTo(gamepadState& state, const gamepadState& baseline) const;
+
+			// Fields:
+			unsigned long long values[GAMEPAD_FIELD_COUNT];
+
+			application::frameNumber frame = 0;
+
+			unsigned char changedFields = 0;
+		};
+
+		// A received state, which was encoded against a baseline we don't have yet.
+		struct gamepadPendingState
+		{
+			// Fields:
+			gamepadStateDelta delta;
+			gamepadButtonEdges edges;
+
+			gamepadSequence sequence;
+			gamepadSequence baseline;
+
+			// When the sender detected this state, and when it arrived here.
+			gamepadTimestamp timestamp;
+
+			high_resolution_clock::time_point arrival;
+		};
+
+		/*
+			This holds the states waiting to be simulated, ordered by sequence.
+
+			States are stored in a ring, indexed by their sequence, so they're kept
+			in order as they arrive. Duplicates, and states older than the last
+			one dequeued are dropped. When a state arrives too far ahead of the
+			oldest state, the oldest states are dropped to make room for it.
+		*/
+
+		struct gamepadStateQueue
+		{
+			// Constructor(s):
+			gamepadStateQueue();
+
+			// Methods:
+
+			// This inserts a state using its sequence. The return value indicates if it was kept.
+			bool push(const gamepadState& state, gamepadSequence sequence);
+
+			// This adds a state after the newest state in this queue. (Used for states without a sequence)
+			bool push(const gamepadState& state);
+
+			// This removes the oldest state; this queue must not be empty.
+			void pop();
+
+			void clear();
+
+			// The oldest state; this queue must not be empty.
+			inline gamepadState& front()
+			{
+				return states[head % GAMEPAD_STATE_QUEUE_CAPACITY];
+			}
+
+			// The newest state; this queue must not be empty.
+			inline const gamepadState& back() const
+			{
+				return states[(gamepadSequence)(tail - 1) % GAMEPAD_STATE_QUEUE_CAPACITY];
+			}
+
+			inline size_t size() const
+			{
+				return count;
+			}
+
+			inline bool empty() const
+			{
+				return (count == 0);
+			}
+
+			// Fields:
+			gamepadState states[GAMEPAD_STATE_QUEUE_CAPACITY];
+			gamepadSequence sequences[GAMEPAD_STATE_QUEUE_CAPACITY];
+			bool present[GAMEPAD_STATE_QUEUE_CAPACITY];
+
+			// The sequence of the oldest state, and the sequence after the newest state.
+			gamepadSequence head = 0;
+			gamepadSequence tail = 0;
+
+			// The sequence of the last state removed with 'pop'.
+			gamepadSequence lastPopped = 0;
+
+			size_t count = 0;
+
+			// Booleans / Flags:
+			bool hasPopped = false;
 		};
 
 		// Classes:
 		class gamepad : public IODevice
 		{
 			public:
+				// Typedefs:
+				typedef sharedStateMemory<nativeGamepad, MAX_GAMEPADS> sharedGamepadMemory;
+
 				// Global variable(s):
-				#ifdef PLATFORM_WINDOWS
-					static HANDLE sharedMemory;
-				#endif
+
+				// Simulated states are published here, for injected processes to read. (Mapped while gamepads are simulated)
+				static sharedGamepadMemory sharedMemory;
 
 				#ifdef GAMEPAD_VJOY_ENABLED
 					static vJoy::vJoyDriver vJoyInfo;
 				#endif
 
+				#ifdef GAMEPAD_EVDEV_ENABLED
+					// Real gamepads are detected using this. (Opened the first time a device is checked for)
+					static evdev::evdevDriver evdevInfo;
+				#endif
+
 				// Functions:
 				#ifdef PLATFORM_WINDOWS
 					static inline DWORD __winnt__realDeviceState(gamepadID identifier, XINPUT_STATE& state)
@@ -347,157 +749,100 @@ namespace iosync
 						// This simulates a gamepad-state using vJoy.
 						static void __winnt__vJoy__simulateState(const gamepadState& state, const UINT vJoyID, const VjdStat status);
 					#endif
+				#endif
 
-					static inline sharedMemoryState __winnt__openSharedMemory()
-					{
-						sharedMemory = OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE, SHARED_GAMEPAD_MEMORY_NAME);
-
-						if (sharedMemory == NULL)
-						{
-							sharedMemory = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, SHARED_GAMEPAD_MEMORY_SIZE, SHARED_GAMEPAD_MEMORY_NAME);
-
-							if (sharedMemory == NULL)
-								return SHARED_MEMORY_UNAVAILABLE;
-						}
-						else
-						{
-							return SHARED_MEMORY_ALREADY_ALLOCATED;
-						}
-
-						// Return the default response.
-						return SHARED_MEMORY_ALLOCATED;
-					}
-
-					static inline bool gamepad::__winnt__closeSharedMemory()
-					{
-						// Close the shared memory handle.
-						CloseHandle(sharedMemory);
-				
-						// Make sure we don't keep a reference to the shared memory.
-						sharedMemory = NULL;
-
-						// Return the default response.
-						return true;
-					}
-
-					static inline bool __winnt__sharedMemoryOpen()
-					{
-						return (sharedMemory != NULL);
-					}
-
-					// This will only return 'false' if this
-					// fails to open the shared memory segment.
-					static inline bool __winnt__autoOpenSharedMemory()
-					{
-						if (__winnt__sharedMemoryOpen())
-							return true;
-
-						return (__winnt__openSharedMemory() != SHARED_MEMORY_UNAVAILABLE);
-					}
-
-					static inline LPVOID __winnt__mapSharedMemory(DWORD desiredAccess=FILE_MAP_READ, SIZE_T size=SHARED_GAMEPAD_MEMORY_SIZE, DWORD highFileOffset=0, DWORD lowFileOffset=0)
+				#ifdef GAMEPAD_EVDEV_ENABLED
+					// This reads every pending event from real devices, including hot-plug notifications.
+					// This is called once per update; while nothing changes, this is the only system-call made.
+					static inline void __linux__pollDevices()
 					{
-						return MapViewOfFile(sharedMemory, desiredAccess, highFileOffset, lowFileOffset, size);
-					}
+						if (!evdevInfo.isOpen())
+							evdevInfo.open();
 
-					static inline void __winnt__unmapSharedMemory(LPCVOID memory)
-					{
-						UnmapViewOfFile(memory);
+						evdevInfo.poll();
 
 						return;
 					}
 
-					// This command will return a pointer to the origin of the
-					// shared-buffer, up to the end of the "plugged in" segment.
-					// This will not offset the buffer, as it needs to be "unmapped".
-					// This can be done using the '__winnt__unmapSharedMemory' command.
-					static inline LPVOID __winnt__map_PluggedIn_Memory(DWORD desiredAccess=FILE_MAP_READ)
-					{
-						return __winnt__mapSharedMemory(desiredAccess, SHARED_GAMEPAD_MEMORY_PLUGGED_IN_MAX_SCOPE);
-					}
+					// This outputs the newest complete state of a real device, as of the last call to '__linux__pollDevices'.
+					// The return value indicates if the device is connected.
+					static bool __linux__realDeviceState(gamepadID identifier, nativeGamepad& state, timeval& timestamp_out);
 
-					// This is the same as '__winnt__map_PluggedIn_Memory', only for the "states" segment.
-					// Please follow the documentation for that command, barring the "scope" differences.
-					static inline LPVOID __winnt__map_States_Memory(DWORD desiredAccess=FILE_MAP_READ)
-					{
-						return __winnt__mapSharedMemory(desiredAccess, SHARED_GAMEPAD_MEMORY_STATES_MAX_SCOPE);
-					}
+					// This records the button transitions a real device reported since the last call, using the kernel's timestamps.
+					static void __linux__realDeviceEdges(gamepadID identifier, gamepadButtonCoalescer& coalescer);
 
-					static inline bool __winnt__setGamepadConnected(gamepadID identifier, bool value)
+					// This command may be used to detect if a real gamepad is connected on the current system.
+					static inline bool __linux__pluggedIn(gamepadID identifier)
 					{
-						if (!__winnt__sharedMemoryOpen())
-							return false;
-
-						// Get direct buffer access.
-						auto buffer = __winnt__mapSharedMemory(FILE_MAP_WRITE, SHARED_GAMEPAD_MEMORY_PLUGGED_IN_MAX_SCOPE);
-
-						bool* pluggedIn = (bool*)__winnt__sharedMemory_getPluggedInOffset(buffer);
-
-						pluggedIn[identifier] = value;
-
-						// Release usage of the buffer.
-						__winnt__unmapSharedMemory(buffer);
-
-						// Return the default response.
-						return true;
+						return evdevInfo.connected((size_t)identifier);
 					}
+				#endif
 
-					static inline bool __winnt__getGamepadConnected(gamepadID identifier)
-					{
-						if (!__winnt__sharedMemoryOpen())
-							return false;
+				#ifdef GAMEPAD_UINPUT_ENABLED
+					// This simulates a gamepad-state using a virtual uinput device.
+					static bool __linux__uinput__simulateState(const gamepadState& state, evdev::uinputGamepad& device);
+				#endif
 
-						// Get direct buffer access.
-						auto buffer = __winnt__map_PluggedIn_Memory(FILE_MAP_READ);
+				// Shared memory related:
+				static inline sharedMemoryState openSharedMemory()
+				{
+					return sharedMemory.open();
+				}
 
-						bool* pluggedIn = (bool*)__winnt__sharedMemory_getPluggedInOffset(buffer);
+				static inline bool closeSharedMemory()
+				{
+					return sharedMemory.close();
+				}
 
-						auto value = pluggedIn[identifier];
+				static inline bool sharedMemoryOpen()
+				{
+					return sharedMemory.isOpen();
+				}
 
-						// Release usage of the buffer.
-						__winnt__unmapSharedMemory(buffer);
+				// This will only return 'false' if this
+				// fails to open the shared memory segment.
+				static inline bool autoOpenSharedMemory()
+				{
+					if (sharedMemoryOpen())
+						return true;
 
-						// Return the current connection-value.
-						return value;
-					}
+					return (openSharedMemory() != SHARED_MEMORY_UNAVAILABLE);
+				}
 
-					static inline bool __winnt__activateGamepad(gamepadID identifier)
-					{
-						return __winnt__setGamepadConnected(identifier, true);
-					}
+				static inline bool setGamepadConnected(gamepadID identifier, bool value)
+				{
+					if (!sharedMemoryOpen())
+						return false;
 
-					static inline bool __winnt__deactivateGamepad(gamepadID identifier)
-					{
-						return __winnt__setGamepadConnected(identifier, false);
-					}
+					sharedMemory.setPluggedIn((size_t)identifier, value);
 
-					static inline size_t __winnt__sharedMemory_getStatesOffset()
-					{
-						return SHARED_GAMEPAD_MEMORY_STATES_OFFSET;
-					}
+					// Return the default response.
+					return true;
+				}
 
-					static inline size_t __winnt__sharedMemory_getPluggedInOffset()
-					{
-						return SHARED_GAMEPAD_MEMORY_PLUGGED_IN_OFFSET;
-					}
+				static inline bool getGamepadConnected(gamepadID identifier)
+				{
+					return sharedMemory.pluggedIn((size_t)identifier);
+				}
 
-					static inline LPVOID __winnt__sharedMemory_getStatesOffset(LPVOID memory)
-					{
-						return (LPVOID)(((unsigned char*)memory)+__winnt__sharedMemory_getStatesOffset());
-					}
+				static inline bool activateGamepad(gamepadID identifier)
+				{
+					return setGamepadConnected(identifier, true);
+				}
 
-					static inline LPVOID __winnt__sharedMemory_getPluggedInOffset(LPVOID memory)
-					{
-						return (LPVOID)(((unsigned char*)memory)+__winnt__sharedMemory_getPluggedInOffset());
-					}
-				#endif
+				static inline bool deactivateGamepad(gamepadID identifier)
+				{
+					return setGamepadConnected(identifier, false);
+				}
 
 				// Platform independent "pluggedIn" command.
 				static inline bool realDeviceConnected(gamepadID identifier)
 				{
-					#ifdef PLATFORM_WINDOWS
+					#if defined(PLATFORM_WINDOWS)
 						//return (__winnt__realDeviceStateResponse(identifier) == ERROR_SUCCESS);
 						return __winnt__pluggedIn(identifier);
+					#elif defined(GAMEPAD_EVDEV_ENABLED)
+						return __linux__pluggedIn(identifier);
 					#else
 						return false;
 					#endif
@@ -542,7 +887,8 @@ namespace iosync
 				gamepadID localGamepadNumber;
 				gamepadID remoteGamepadNumber;
 
-				deque<gamepadState> stateLog;
+				// The states waiting to be simulated.
+				gamepadStateQueue stateLog;
 
 				// The last "frame" we simulated on.
 				application::frameNumber previousFrameIn = 0;
@@ -552,9 +898,106 @@ namespace iosync
 				// Behavior is partially undefined for purely "virtual" devices.
 				gamepadState localState;
 
+				// Applied to detected states, so analog noise isn't reported as new input.
+				gamepadConditioning conditioning;
+
+				// The button transitions detected since the last state was sent.
+				gamepadButtonCoalescer buttonCoalescer;
+
+				// When 'localState' was detected (On Linux, when the kernel produced it); sent with it, so receivers can tell input spacing from network jitter.
+				gamepadTimestamp localStateTimestamp = 0;
+
 				// Used externally; a pointer to a player/connection which owns this object.
 				networking::player* owner = nullptr;
 
+				// Delta-encoding (Outgoing):
+
+				// The states we've recently sent, indexed by sequence.
+				gamepadState sentStates[GAMEPAD_DELTA_HISTORY];
+
+				// Reliable packets carrying our states, which have yet to be confirmed.
+				deque<pair<networking::packetID, gamepadSequence>> unconfirmedStates;
+
+				gamepadSequence nextSequence = 0;
+				gamepadSequence lastSentSequence = 0;
+
+				// The newest state every remote connection has confirmed.
+				gamepadSequence baselineSequence = 0;
+
+				unsigned int statesSinceKeyframe = 0;
+
+				bool hasBaseline = false;
+
+				// Delta-encoding (Incoming):
+
+				// The states we've recently received, indexed by sequence.
+				gamepadState receivedStates[GAMEPAD_DELTA_HISTORY];
+				gamepadSequence receivedSequences[GAMEPAD_DELTA_HISTORY];
+				bool receivedValid[GAMEPAD_DELTA_HISTORY];
+
+				// States waiting for their baselines, oldest first.
+				deque<gamepadPendingState> pendingStates;
+
+				gamepadSequence lastReceivedSequence = 0;
+
+				bool hasReceivedState = false;
+				bool hasSentState = false;
+
+				// Heartbeats:
+
+				// A "snapshot" of the last time we heard about this gamepad.
+				high_resolution_clock::time_point lastActivity = high_resolution_clock::now();
+
+				// Set once a period of silence has been reported; cleared by new activity.
+				bool silenceReported = false;
+
+				// Jitter buffering:
+
+				// A "snapshot" of when the last state arrived, and when its sender detected it.
+				high_resolution_clock::time_point lastArrival;
+
+				gamepadTimestamp lastArrivalTimestamp = 0;
+
+				// A running average of how much the time states take to arrive varies. (In milliseconds)
+				double arrivalJitter = 0.0;
+
+				// The most latency buffering may add; the target depth never exceeds this.
+				milliseconds maximumLatency = (milliseconds)DEFAULT_GAMEPAD_MAXIMUM_LATENCY;
+
+				bool hasArrival = false;
+
+				// Analog reconstruction:
+				gamepadReconstruction reconstruction;
+
+				// The last two received states we simulated; used to find where the analog inputs were heading.
+				gamepadState lastSimulatedState;
+				gamepadState priorSimulatedState;
+
+				// The last state simulated; reconstructed states included.
+				gamepadState lastOutputState;
+
+				// The position, and per-frame velocity of each analog input being extrapolated.
+				double extrapolatedValues[GAMEPAD_FIELD_ANALOG_COUNT];
+				double extrapolationVelocity[GAMEPAD_FIELD_ANALOG_COUNT];
+
+				// A "snapshot" of when extrapolation began.
+				high_resolution_clock::time_point underrunSnapshot;
+
+				// The frame the last reconstructed state was simulated on.
+				application::frameNumber reconstructedFrame = 0;
+
+				// Advanced with every state simulated, so reconstructed states are seen as new input.
+				unsigned int outputPacketNumber = 0;
+
+				// The number of button transitions replayed from the state at the front of 'stateLog'.
+				unsigned char replayedEdges = 0;
+
+				bool hasSimulatedState = false;
+				bool extrapolating = false;
+
+				// Set once extrapolation runs out; the buffer must be refilled before simulating again.
+				bool extrapolationExpired = false;
+
 				#ifdef PLATFORM_WINDOWS
 					DWORD __winnt__lastPacketNumber = 0;
 					DWORD __winnt__state_meta = ERROR_SUCCESS;
@@ -565,6 +1008,15 @@ namespace iosync
 					#endif
 				#endif
 
+				#ifdef GAMEPAD_EVDEV_ENABLED
+					unsigned int __linux__lastPacketNumber = 0;
+				#endif
+
+				#ifdef GAMEPAD_UINPUT_ENABLED
+					// The virtual device simulated states are applied to. (Created while this gamepad is connected)
+					evdev::uinputGamepad __linux__uinputDevice;
+				#endif
+
 				// Constructor(s):
 				gamepad(gamepadID localIdentifier, gamepadID remoteIdentifier, bool canDetect=true, bool canSimulate=true, deviceFlags flagsToAdd=deviceFlags());
 
@@ -585,6 +1037,94 @@ namespace iosync
 				// This command simulates the current state if 'hasState' specifies to do so.
 				bool simulateState(iosync_application& program);
 
+				// Delta-encoding:
+
+				// This should be called with the identifier of the reliable
+				// packet carrying the state most recently written by 'writeTo'.
+				void onStateSent(networking::packetID ID);
+
+				// This is called once every remote connection has confirmed the packet specified.
+				// The return value of this command indicates if the packet carried one of our states.
+				bool onPacketConfirmed(networking::packetID ID);
+
+				// This forces the next state to be sent as a keyframe. (Used when a connection lacks our baseline)
+				void resetBaseline();
+
+				// Heartbeats:
+
+				// This writes a summary of the last state sent; this is always encoded as a keyframe.
+				void writeHeartbeatTo(QSocket& socket);
+
+				// This reads a heartbeat, recovering the summarized state if we never received it.
+				void readHeartbeatFrom(QSocket& socket);
+
+				// Delta-encoding (Incoming):
+
+				// This specifies if the state with this sequence is still available as a baseline.
+				inline bool hasReceived(gamepadSequence sequence) const
+				{
+					auto slot = (sequence % GAMEPAD_DELTA_HISTORY);
+
+					return (receivedValid[slot] && receivedSequences[slot] == sequence);
+				}
+
+				// This keeps 'state' as a baseline, then queues it to be simulated. (See 'onStateArrived')
+				void acceptState(const gamepadState& state, gamepadSequence sequence, gamepadTimestamp timestamp, high_resolution_clock::time_point arrival);
+
+				// This decodes any pending states whose baselines have arrived, and drops those whose baselines never will.
+				void resolvePendingStates();
+
+				// The amount of time since we last heard about this gamepad.
+				inline milliseconds silence() const
+				{
+					return elapsed(lastActivity);
+				}
+
+				// Jitter buffering:
+
+				/*
+					This updates the arrival statistics of this gamepad; called as received states are queued.
+
+					States are only sent when input changes, so the time between arrivals says more about the player
+					than the network. Instead, the time between arrivals is compared with the time between detections,
+					using the sender's 'timestamp'; only the difference (The variation in transit time) counts as jitter.
+				*/
+
+				void onStateArrived(gamepadTimestamp timestamp, high_resolution_clock::time_point arrival);
+
+				/*
+					This calculates the number of states to buffer before simulating,
+					using the measured arrival jitter, and the update-rate of 'program'.
+					This is at least one state, and no more than 'maximumLatency' allows.
+				*/
+
+				size_t targetDepth(const iosync_application& program) const;
+
+				// This specifies if enough states are buffered to begin simulating.
+				inline bool bufferReady(const iosync_application& program) const
+				{
+					return (!stateLog.empty() && stateLog.size() >= targetDepth(program));
+				}
+
+				// Analog reconstruction:
+
+				// This simulates 'state' as-is, using the next output packet number.
+				void outputState(gamepadState state);
+
+				// This simulates the last state, blended toward 'next' by the frames that have passed since.
+				// The return value of this command indicates if a state was simulated.
+				bool interpolateState(iosync_application& program, const gamepadState& next);
+
+				// This continues the analog inputs of the last state simulated, while no states are buffered.
+				// The return value of this command indicates if a state was simulated.
+				bool extrapolateState(iosync_application& program);
+
+				// This specifies if an underrun may be covered by extrapolation, rather than suspending.
+				inline bool canExtrapolate() const
+				{
+					return (hasSimulatedState && !extrapolationExpired && reconstruction.canExtrapolate());
+				}
+
 				#ifdef GAMEPAD_VJOY_ENABLED
 					// This will set the internal vJoy status of this device.
 					VjdStat __winnt__vJoy__calculateStatus();
@@ -592,8 +1132,10 @@ namespace iosync
 
 				inline bool hasRealState() const
 				{
-					#ifdef PLATFORM_WINDOWS
+					#if defined(PLATFORM_WINDOWS)
 						return (localState.native.dwPacketNumber != __winnt__lastPacketNumber);
+					#elif defined(GAMEPAD_EVDEV_ENABLED)
+						return (localState.native.packetNumber != __linux__lastPacketNumber);
 					#else
 						return false;
 					#endif
@@ -606,7 +1148,7 @@ namespace iosync
 
 				inline bool hasState() const
 				{
-					#ifdef PLATFORM_WINDOWS
+					#if defined(PLATFORM_WINDOWS) || defined(GAMEPAD_EVDEV_ENABLED)
 						return (hasRealState() || hasStates());
 					#else
 						return false;
@@ -615,8 +1157,10 @@ namespace iosync
 
 				inline bool connected_real() const
 				{
-					#ifdef PLATFORM_WINDOWS
+					#if defined(PLATFORM_WINDOWS)
 						return (__winnt__state_meta != ERROR_DEVICE_NOT_CONNECTED);
+					#elif defined(GAMEPAD_EVDEV_ENABLED)
+						return __linux__pluggedIn(localGamepadNumber);
 					#else
 						return true;
 					#endif
@@ -0,0 +1,188 @@
+// Includes:
+#include "gamepadTable.h"
+
+// Namespace(s):
+namespace iosync
+{
+	namespace devices
+	{
+		// Classes:
+
+		// gamepadTable:
+
+		// Constructor(s):
+		gamepadTable::gamepadTable(size_t capacity)
+		{
+			resize(capacity);
+		}
+
+		// Methods:
+		void gamepadTable::resize(size_t capacity)
+		{
+			capacity = min(capacity, (size_t)MAX_GAMEPAD_TABLE_SIZE);
+
+			// Slots holding gamepads are never removed; the table only shrinks down to its last used slot.
+			for (auto i = this->capacity(); i > capacity; i--)
+			{
+				if ((flags[i-1] & GAMEPAD_SLOT_USED) != 0)
+				{
+					capacity = i;
+
+					break;
+				}
+			}
+
+			pads.resize(capacity, nullptr);
+			remoteIdentifiers.resize(capacity, (gamepadID)GAMEPAD_ID_NONE);
+			owners.resize(capacity, nullptr);
+			flags.resize(capacity, GAMEPAD_SLOT_EMPTY);
+
+			rebuildFreeList();
+
+			return;
+		}
+
+		void gamepadTable::insert(gamepadID slot, gamepad* pad)
+		{
+			if (slot >= capacity() || (flags[slot] & GAMEPAD_SLOT_USED) != 0)
+				return;
+
+			pads[slot] = pad;
+			flags[slot] = (flags[slot] & GAMEPAD_SLOT_RESERVED) | GAMEPAD_SLOT_USED;
+
+			used++;
+
+			// The slot's heap entry is now stale, and will be skipped by 'nextFree'.
+			refresh(slot);
+
+			return;
+		}
+
+		gamepad* gamepadTable::remove(gamepadID slot)
+		{
+			if (slot >= capacity() || (flags[slot] & GAMEPAD_SLOT_USED) == 0)
+				return nullptr;
+
+			auto pad = pads[slot];
+
+			pads[slot] = nullptr;
+			remoteIdentifiers[slot] = (gamepadID)GAMEPAD_ID_NONE;
+			owners[slot] = nullptr;
+			flags[slot] &= GAMEPAD_SLOT_RESERVED;
+
+			used--;
+
+			pushFree(slot);
+
+			return pad;
+		}
+
+		void gamepadTable::refresh(gamepadID slot)
+		{
+			if (slot >= capacity() || pads[slot] == nullptr)
+				return;
+
+			// Local variable(s):
+			auto pad = pads[slot];
+
+			unsigned char state = (flags[slot] & GAMEPAD_SLOT_RESERVED) | GAMEPAD_SLOT_USED;
+
+			if (pad->connected())
+				state |= GAMEPAD_SLOT_CONNECTED;
+
+			if (pad->canDetect())
+				state |= GAMEPAD_SLOT_DETECTS;
+
+			if (pad->canSimulate())
+				state |= GAMEPAD_SLOT_SIMULATES;
+
+			flags[slot] = state;
+
+			remoteIdentifiers[slot] = pad->remoteGamepadNumber;
+			owners[slot] = pad->owner;
+
+			return;
+		}
+
+		void gamepadTable::setOwner(gamepadID slot, networking::player* owner)
+		{
+			if (slot >= capacity() || pads[slot] == nullptr)
+				return;
+
+			pads[slot]->owner = owner;
+			owners[slot] = owner;
+
+			return;
+		}
+
+		void gamepadTable::reserve(gamepadID slot)
+		{
+			if (slot < capacity())
+				flags[slot] |= GAMEPAD_SLOT_RESERVED;
+
+			return;
+		}
+
+		void gamepadTable::unreserve(gamepadID slot)
+		{
+			if (slot < capacity())
+				flags[slot] &= ~GAMEPAD_SLOT_RESERVED;
+
+			return;
+		}
+
+		void gamepadTable::clearReservations()
+		{
+			for (auto& state : flags)
+			{
+				state &= ~GAMEPAD_SLOT_RESERVED;
+			}
+
+			return;
+		}
+
+		gamepadID gamepadTable::findRemote(gamepadID remoteIdentifier) const
+		{
+			for (size_t i = 0; i < capacity(); i++)
+			{
+				if ((flags[i] & GAMEPAD_SLOT_CONNECTED) != 0 && remoteIdentifiers[i] == remoteIdentifier)
+					return (gamepadID)i;
+			}
+
+			return GAMEPAD_ID_NONE;
+		}
+
+		// Methods (Protected):
+		void gamepadTable::pushFree(gamepadID slot)
+		{
+			// Entries are never removed when slots are taken, so the heap may fill with stale entries.
+			if (freeSlots.size() >= (capacity() * 2))
+			{
+				rebuildFreeList();
+
+				return;
+			}
+
+			freeSlots.push_back(slot);
+
+			push_heap(freeSlots.begin(), freeSlots.end(), greater<gamepadID>());
+
+			return;
+		}
+
+		void gamepadTable::rebuildFreeList()
+		{
+			freeSlots.clear();
+
+			for (size_t i = 0; i < capacity(); i++)
+			{
+				if ((flags[i] & GAMEPAD_SLOT_USED) == 0)
+					freeSlots.push_back((gamepadID)i);
+			}
+
+			make_heap(freeSlots.begin(), freeSlots.end(), greater<gamepadID>());
+
+			return;
+		}
+	}
+}
\ No newline at end of file
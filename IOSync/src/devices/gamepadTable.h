@@ -0,0 +1,217 @@
+#pragma once
+
+// Includes:
+#include "gamepad.h"
+
+// Standard library:
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+// Namespace(s):
+namespace iosync
+{
+	namespace devices
+	{
+		// Enumerator(s):
+		enum gamepadTableMetrics : size_t
+		{
+			// The most slots a table may have; identifiers are serialized as a single byte, and 'GAMEPAD_ID_NONE' is reserved.
+			MAX_GAMEPAD_TABLE_SIZE = GAMEPAD_ID_NONE,
+		};
+
+		enum gamepadSlotFlags : unsigned char
+		{
+			GAMEPAD_SLOT_EMPTY = 0,
+
+			// The slot holds a gamepad.
+			GAMEPAD_SLOT_USED = 1,
+
+			// The gamepad in this slot is connected.
+			GAMEPAD_SLOT_CONNECTED = 2,
+
+			// The gamepad in this slot detects, or simulates states, respectively.
+			GAMEPAD_SLOT_DETECTS = 4,
+			GAMEPAD_SLOT_SIMULATES = 8,
+
+			// This identifier is reserved; a connection was requested, but not confirmed yet. (Used by clients)
+			GAMEPAD_SLOT_RESERVED = 16,
+		};
+
+		// Classes:
+
+		/*
+			This holds every 'gamepad' object, indexed by local identifier.
+
+			The table is sized from configuration, and may hold far more gamepads than
+			a system has native slots for. (Hubs simulate a gamepad per remote player)
+
+			The slot metadata that's checked every update (Which slots are used, connected,
+			detecting or simulating, as well as each slot's remote identifier and owner)
+			is stored in separate contiguous arrays, so iterating the table doesn't
+			touch gamepad objects that aren't relevant. States and sequence numbers
+			still belong to each 'gamepad' object.
+
+			Free slots are kept in a min-heap, so the lowest free identifier is
+			always allocated first, without scanning the table.
+			Slots may also be taken directly; stale heap entries are skipped lazily.
+		*/
+
+		class gamepadTable
+		{
+			public:
+				// Constructor(s):
+				gamepadTable(size_t capacity=MAX_GAMEPADS);
+
+				// Methods:
+
+				// This changes the number of slots; slots holding gamepads are never removed.
+				void resize(size_t capacity);
+
+				/*
+					This finds the lowest free slot, without taking it. (See 'insert')
+					Slots rejected by 'predicate' are skipped, but stay free.
+					If no slot is available, this returns 'GAMEPAD_ID_NONE'.
+				*/
+
+				template <typename predicateFunction>
+				gamepadID nextFree(predicateFunction predicate);
+
+				inline gamepadID nextFree()
+				{
+					return nextFree([](gamepadID) { return true; });
+				}
+
+				// This places 'pad' in 'slot', which must be free.
+				void insert(gamepadID slot, gamepad* pad);
+
+				// This frees 'slot', and returns the gamepad it held. (The gamepad isn't destroyed)
+				gamepad* remove(gamepadID slot);
+
+				// This re-reads the cached state of the gamepad in 'slot'. (Used after connecting or disconnecting it)
+				void refresh(gamepadID slot);
+
+				void setOwner(gamepadID slot, networking::player* owner);
+
+				// Reservations:
+				void reserve(gamepadID slot);
+				void unreserve(gamepadID slot);
+				void clearReservations();
+
+				inline bool reserved(gamepadID slot) const
+				{
+					return hasFlag(slot, GAMEPAD_SLOT_RESERVED);
+				}
+
+				// Accessors:
+				inline size_t capacity() const
+				{
+					return pads.size();
+				}
+
+				// The number of slots holding gamepads.
+				inline size_t size() const
+				{
+					return used;
+				}
+
+				inline gamepad* operator[](gamepadID slot) const
+				{
+					return (slot < capacity()) ? pads[slot] : nullptr;
+				}
+
+				inline bool hasFlag(gamepadID slot, gamepadSlotFlags flag) const
+				{
+					return (slot < capacity() && (flags[slot] & flag) != 0);
+				}
+
+				inline bool connected(gamepadID slot) const
+				{
+					return hasFlag(slot, GAMEPAD_SLOT_CONNECTED);
+				}
+
+				inline bool detects(gamepadID slot) const
+				{
+					return hasFlag(slot, GAMEPAD_SLOT_DETECTS);
+				}
+
+				inline bool simulates(gamepadID slot) const
+				{
+					return hasFlag(slot, GAMEPAD_SLOT_SIMULATES);
+				}
+
+				inline gamepadID remoteIdentifier(gamepadID slot) const
+				{
+					return remoteIdentifiers[slot];
+				}
+
+				inline networking::player* owner(gamepadID slot) const
+				{
+					return owners[slot];
+				}
+
+				// This finds the connected gamepad with the remote identifier specified. ('GAMEPAD_ID_NONE' if none is connected)
+				gamepadID findRemote(gamepadID remoteIdentifier) const;
+			protected:
+				// Methods (Protected):
+				void pushFree(gamepadID slot);
+
+				// This rebuilds the free-list from the table's flags.
+				void rebuildFreeList();
+
+				// Fields (Protected):
+
+				// Per-slot state:
+				vector<gamepad*> pads;
+				vector<gamepadID> remoteIdentifiers;
+				vector<networking::player*> owners;
+				vector<unsigned char> flags;
+
+				// A min-heap of free slots; this may hold entries for slots that have since been taken.
+				vector<gamepadID> freeSlots;
+
+				size_t used = 0;
+		};
+
+		// Methods:
+		template <typename predicateFunction>
+		gamepadID gamepadTable::nextFree(predicateFunction predicate)
+		{
+			// Local variable(s):
+
+			// Free slots rejected by 'predicate'; these are returned to the heap afterward.
+			vector<gamepadID> skipped;
+
+			auto response = (gamepadID)GAMEPAD_ID_NONE;
+
+			while (!freeSlots.empty())
+			{
+				auto slot = freeSlots.front();
+
+				pop_heap(freeSlots.begin(), freeSlots.end(), greater<gamepadID>());
+				freeSlots.pop_back();
+
+				// Skip stale entries, and entries past a reduced capacity.
+				if (slot >= capacity() || (flags[slot] & GAMEPAD_SLOT_USED) != 0)
+					continue;
+
+				// Either way, the slot stays free until it's taken with 'insert'.
+				skipped.push_back(slot);
+
+				if (predicate(slot))
+				{
+					response = slot;
+
+					break;
+				}
+			}
+
+			for (auto slot : skipped)
+			{
+				pushFree(slot);
+			}
+
+			return response;
+		}
+	}
+}
\ No newline at end of file
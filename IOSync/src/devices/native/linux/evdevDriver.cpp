@@ -0,0 +1,726 @@
+// Includes:
+#include "evdevDriver.h"
+
+#ifdef GAMEPAD_EVDEV_ENABLED
+	// Linux-specific:
+	#include <sys/epoll.h>
+	#include <sys/inotify.h>
+	#include <sys/ioctl.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <dirent.h>
+	#include <cerrno>
+	#include <ctime>
+
+	// Standard library:
+	#include <vector>
+	#include <algorithm>
+	#include <climits>
+	#include <cstring>
+
+	// Namespace(s):
+	namespace iosync
+	{
+		namespace devices
+		{
+			namespace evdev
+			{
+				// Constant variable(s):
+				static const size_t BITS_PER_LONG = (sizeof(unsigned long) * CHAR_BIT);
+
+				// Global variable(s):
+				const unsigned short gamepadButtonCodes[EVDEV_GAMEPAD_BUTTON_COUNT] =
+				{
+					BTN_A, BTN_B, BTN_X, BTN_Y,
+					BTN_TL, BTN_TR,
+					BTN_SELECT, BTN_START, BTN_MODE,
+					BTN_THUMBL, BTN_THUMBR,
+				};
+
+				// Functions:
+				static inline bool testBit(const unsigned long* bits, unsigned int bit)
+				{
+					return (((bits[bit / BITS_PER_LONG] >> (bit % BITS_PER_LONG)) & 1) != 0);
+				}
+
+				unsigned int buttonMask(unsigned int code)
+				{
+					switch (code)
+					{
+						case BTN_A: return EVDEV_BUTTON_A;
+						case BTN_B: return EVDEV_BUTTON_B;
+						case BTN_X: return EVDEV_BUTTON_X;
+						case BTN_Y: return EVDEV_BUTTON_Y;
+
+						case BTN_TL: return EVDEV_BUTTON_LEFT_SHOULDER;
+						case BTN_TR: return EVDEV_BUTTON_RIGHT_SHOULDER;
+
+						case BTN_SELECT: return EVDEV_BUTTON_BACK;
+						case BTN_START: return EVDEV_BUTTON_START;
+						case BTN_MODE: return EVDEV_BUTTON_GUIDE;
+
+						case BTN_THUMBL: return EVDEV_BUTTON_LEFT_THUMB;
+						case BTN_THUMBR: return EVDEV_BUTTON_RIGHT_THUMB;
+
+						// Some drivers report the D-pad as buttons, rather than a hat.
+						case BTN_DPAD_UP: return EVDEV_BUTTON_DPAD_UP;
+						case BTN_DPAD_DOWN: return EVDEV_BUTTON_DPAD_DOWN;
+						case BTN_DPAD_LEFT: return EVDEV_BUTTON_DPAD_LEFT;
+						case BTN_DPAD_RIGHT: return EVDEV_BUTTON_DPAD_RIGHT;
+					}
+
+					return 0;
+				}
+
+				// This scales 'value' from the range of 'axis', to [0, range].
+				static inline long long scaleAxis(const input_absinfo& axis, int value, long long range)
+				{
+					// Local variable(s):
+					long long span = ((long long)axis.maximum - (long long)axis.minimum);
+
+					if (span <= 0)
+						return 0;
+
+					value = max(axis.minimum, min(axis.maximum, value));
+
+					return ((((long long)value - (long long)axis.minimum) * range) / span);
+				}
+
+				// Vertical axes are inverted, since XInput considers "up" to be positive.
+				static inline short thumbValue(const input_absinfo& axis, int value, bool vertical)
+				{
+					// Local variable(s):
+					auto scaled = scaleAxis(axis, value, USHRT_MAX);
+
+					if (vertical)
+						return (short)(SHRT_MAX - scaled);
+
+					return (short)(scaled + SHRT_MIN);
+				}
+
+				static inline unsigned char triggerValue(const input_absinfo& axis, int value)
+				{
+					return (unsigned char)scaleAxis(axis, value, UCHAR_MAX);
+				}
+
+				static inline void setHat(unsigned int& buttons, int value, unsigned int negative, unsigned int positive)
+				{
+					buttons &= ~(negative | positive);
+
+					if (value < 0)
+						buttons |= negative;
+					else if (value > 0)
+						buttons |= positive;
+
+					return;
+				}
+
+				// Classes:
+
+				// evdevDriver:
+
+				// Functions:
+				bool evdevDriver::isGamepad(int descriptor)
+				{
+					// Local variable(s):
+					unsigned long eventBits[(EV_MAX / BITS_PER_LONG) + 1];
+					unsigned long keyBits[(KEY_MAX / BITS_PER_LONG) + 1];
+					unsigned long axisBits[(ABS_MAX / BITS_PER_LONG) + 1];
+
+					ZeroVariable(eventBits);
+					ZeroVariable(keyBits);
+					ZeroVariable(axisBits);
+
+					if (ioctl(descriptor, EVIOCGBIT(0, sizeof(eventBits)), eventBits) < 0)
+						return false;
+
+					if (!testBit(eventBits, EV_KEY) || !testBit(eventBits, EV_ABS))
+						return false;
+
+					if (ioctl(descriptor, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) < 0 || ioctl(descriptor, EVIOCGBIT(EV_ABS, sizeof(axisBits)), axisBits) < 0)
+						return false;
+
+					if (!testBit(axisBits, ABS_X) || !testBit(axisBits, ABS_Y))
+						return false;
+
+					// Joysticks and gamepads share one range of button codes. (Mice, and tablets don't)
+					for (unsigned int code = BTN_JOYSTICK; code < BTN_DIGI; code++)
+					{
+						if (testBit(keyBits, code))
+							return true;
+					}
+
+					return false;
+				}
+
+				// Constructor(s):
+				evdevDriver::evdevDriver() { /* Nothing so far. */ }
+
+				// Destructor(s):
+				evdevDriver::~evdevDriver()
+				{
+					close();
+				}
+
+				// Methods:
+				bool evdevDriver::open()
+				{
+					if (isOpen())
+						return true;
+
+					pollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+
+					if (!isOpen())
+						return false;
+
+					// Start watching before looking for devices, so none are missed in between.
+					// Without hot-plug notifications, only the devices found here are detected.
+					watch(EVDEV_INPUT_DIRECTORY);
+
+					discover();
+
+					// Return the default response.
+					return true;
+				}
+
+				void evdevDriver::close()
+				{
+					if (!isOpen())
+						return;
+
+					for (size_t slot = 0; slot < MAX_EVDEV_DEVICES; slot++)
+					{
+						if (connected(slot))
+							remove(slot);
+					}
+
+					if (notifyDescriptor >= 0)
+					{
+						::close(notifyDescriptor);
+
+						notifyDescriptor = -1;
+					}
+
+					::close(pollDescriptor);
+
+					pollDescriptor = -1;
+
+					return;
+				}
+
+				size_t evdevDriver::discover(const string& directory)
+				{
+					if (!isOpen())
+						return 0;
+
+					// Local variable(s):
+					auto directoryHandle = opendir(directory.c_str());
+
+					vector<string> names;
+					size_t added = 0;
+
+					if (directoryHandle == nullptr)
+						return 0;
+
+					while (auto entry = readdir(directoryHandle))
+					{
+						if (strncmp(entry->d_name, EVDEV_DEVICE_PREFIX, strlen(EVDEV_DEVICE_PREFIX)) == 0)
+						{
+							names.push_back(entry->d_name);
+						}
+					}
+
+					closedir(directoryHandle);
+
+					// Order devices by number, so slots are assigned consistently. ("event2" before "event10")
+					sort(names.begin(), names.end(), [](const string& X, const string& Y) { return (X.length() != Y.length()) ? (X.length() < Y.length()) : (X < Y); });
+
+					for (const auto& name : names)
+					{
+						auto path = (directory + "/" + name);
+
+						if (slotOf(path) >= MAX_EVDEV_DEVICES && add(path))
+							added++;
+					}
+
+					return added;
+				}
+
+				size_t evdevDriver::poll()
+				{
+					if (!isOpen())
+						return 0;
+
+					// Local variable(s):
+					epoll_event events[MAX_EVDEV_DEVICES + 1];
+
+					size_t reports = 0;
+
+					auto count = epoll_wait(pollDescriptor, events, (MAX_EVDEV_DEVICES + 1), 0);
+
+					for (int i = 0; i < count; i++)
+					{
+						auto slot = (size_t)events[i].data.u32;
+
+						if (slot == EVDEV_HOTPLUG_EVENT)
+						{
+							readNotifications();
+
+							continue;
+						}
+
+						if (!connected(slot))
+							continue;
+
+						// Read anything left, even if the device was unplugged.
+						auto stillConnected = read(devices[slot], reports);
+
+						if (!stillConnected || (events[i].events & (EPOLLHUP | EPOLLERR)) != 0)
+						{
+							remove(slot);
+						}
+					}
+
+					return reports;
+				}
+
+				bool evdevDriver::state(size_t slot, evdevReport& report_out) const
+				{
+					if (!connected(slot))
+						return false;
+
+					report_out = devices[slot].report;
+
+					return true;
+				}
+
+				size_t evdevDriver::takeEdges(size_t slot, evdevButtonEdge* edges_out, size_t maximum)
+				{
+					if (!connected(slot))
+						return 0;
+
+					// Local variable(s):
+					auto& device = devices[slot];
+
+					// If there isn't room for every transition, the newest ones are kept.
+					auto count = min(device.edgeCount, maximum);
+
+					copy((device.edges + (device.edgeCount - count)), (device.edges + device.edgeCount), edges_out);
+
+					device.edgeCount = 0;
+
+					return count;
+				}
+
+				bool evdevDriver::add(const string& path)
+				{
+					// Local variable(s):
+					auto slot = (size_t)(find_if(begin(devices), end(devices), [](const evdevDevice& device) { return !device.isOpen(); }) - begin(devices));
+
+					if (slot >= MAX_EVDEV_DEVICES)
+						return false;
+
+					auto descriptor = ::open(path.c_str(), (O_RDONLY | O_NONBLOCK | O_CLOEXEC));
+
+					if (descriptor < 0)
+						return false;
+
+					// Local variable(s):
+					char name[256];
+					unsigned long axisBits[(ABS_MAX / BITS_PER_LONG) + 1];
+
+					ZeroVariable(name);
+					ZeroVariable(axisBits);
+
+					ioctl(descriptor, EVIOCGNAME(sizeof(name) - 1), name);
+
+					if (!isGamepad(descriptor) || strncmp(name, EVDEV_VIRTUAL_DEVICE_PREFIX, strlen(EVDEV_VIRTUAL_DEVICE_PREFIX)) == 0)
+					{
+						::close(descriptor);
+
+						return false;
+					}
+
+					ioctl(descriptor, EVIOCGBIT(EV_ABS, sizeof(axisBits)), axisBits);
+
+					// Timestamp events using the same clock as 'steady_clock'. (This isn't supported by older kernels)
+					int clock = CLOCK_MONOTONIC;
+
+					ioctl(descriptor, EVIOCSCLOCKID, &clock);
+
+					auto& device = devices[slot];
+
+					device = evdevDevice();
+
+					for (unsigned int code = 0; code < ABS_CNT; code++)
+					{
+						if (testBit(axisBits, code))
+						{
+							ioctl(descriptor, EVIOCGABS(code), &device.axes[code]);
+						}
+					}
+
+					device.path = path;
+					device.name = name;
+					device.descriptor = descriptor;
+
+					// Devices without separate axes for their triggers report them as buttons. (See 'handle')
+					device.analogTriggers = ((testBit(axisBits, ABS_Z) && testBit(axisBits, ABS_RZ)) || (testBit(axisBits, ABS_BRAKE) && testBit(axisBits, ABS_GAS)));
+
+					// Events are delivered to 'poll' tagged with the slot of their device.
+					epoll_event registration;
+
+					ZeroVariable(registration);
+
+					registration.events = EPOLLIN;
+					registration.data.u32 = (uint32_t)slot;
+
+					if (epoll_ctl(pollDescriptor, EPOLL_CTL_ADD, descriptor, &registration) != 0)
+					{
+						::close(descriptor);
+
+						device = evdevDevice();
+
+						return false;
+					}
+
+					// Start with the device's current state, rather than waiting for it to change.
+					synchronize(device);
+
+					// Return the default response.
+					return true;
+				}
+
+				void evdevDriver::remove(size_t slot)
+				{
+					// Local variable(s):
+					auto& device = devices[slot];
+
+					epoll_ctl(pollDescriptor, EPOLL_CTL_DEL, device.descriptor, nullptr);
+
+					::close(device.descriptor);
+
+					device = evdevDevice();
+
+					return;
+				}
+
+				size_t evdevDriver::slotOf(const string& path) const
+				{
+					for (size_t slot = 0; slot < MAX_EVDEV_DEVICES; slot++)
+					{
+						if (devices[slot].isOpen() && devices[slot].path == path)
+							return slot;
+					}
+
+					return MAX_EVDEV_DEVICES;
+				}
+
+				bool evdevDriver::watch(const string& directory)
+				{
+					notifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+					if (notifyDescriptor < 0)
+						return false;
+
+					// Device nodes are usually created before their permissions are set, so attribute changes are watched too.
+					if (inotify_add_watch(notifyDescriptor, directory.c_str(), (IN_CREATE | IN_ATTRIB | IN_DELETE)) < 0)
+					{
+						::close(notifyDescriptor);
+
+						notifyDescriptor = -1;
+
+						return false;
+					}
+
+					// Local variable(s):
+					epoll_event registration;
+
+					ZeroVariable(registration);
+
+					registration.events = EPOLLIN;
+					registration.data.u32 = EVDEV_HOTPLUG_EVENT;
+
+					if (epoll_ctl(pollDescriptor, EPOLL_CTL_ADD, notifyDescriptor, &registration) != 0)
+					{
+						::close(notifyDescriptor);
+
+						notifyDescriptor = -1;
+
+						return false;
+					}
+
+					watchedDirectory = directory;
+
+					// Return the default response.
+					return true;
+				}
+
+				void evdevDriver::readNotifications()
+				{
+					// Local variable(s):
+					alignas(inotify_event) char buffer[EVDEV_HOTPLUG_BUFFER_SIZE];
+
+					while (true)
+					{
+						auto bytesRead = ::read(notifyDescriptor, buffer, sizeof(buffer));
+
+						if (bytesRead < 0 && errno == EINTR)
+							continue;
+
+						if (bytesRead <= 0)
+							break;
+
+						for (ssize_t offset = 0; offset < bytesRead; )
+						{
+							auto notification = (const inotify_event*)(buffer + offset);
+
+							offset += (ssize_t)(sizeof(inotify_event) + notification->len);
+
+							// Notifications were lost; look for anything we missed.
+							if ((notification->mask & IN_Q_OVERFLOW) != 0)
+							{
+								discover(watchedDirectory);
+
+								continue;
+							}
+
+							if (notification->len == 0 || strncmp(notification->name, EVDEV_DEVICE_PREFIX, strlen(EVDEV_DEVICE_PREFIX)) != 0)
+								continue;
+
+							auto path = (watchedDirectory + "/" + notification->name);
+							auto slot = slotOf(path);
+
+							if ((notification->mask & IN_DELETE) != 0)
+							{
+								if (slot < MAX_EVDEV_DEVICES)
+									remove(slot);
+							}
+							else if (slot >= MAX_EVDEV_DEVICES)
+							{
+								add(path);
+							}
+						}
+					}
+
+					return;
+				}
+
+				bool evdevDriver::read(evdevDevice& device, size_t& reports)
+				{
+					// Local variable(s):
+					input_event events[EVDEV_EVENT_BATCH];
+
+					while (true)
+					{
+						auto bytesRead = ::read(device.descriptor, events, sizeof(events));
+
+						if (bytesRead < 0)
+						{
+							if (errno == EINTR)
+								continue;
+
+							// Nothing left to read; anything else means the device is gone. (Usually 'ENODEV')
+							return (errno == EAGAIN || errno == EWOULDBLOCK);
+						}
+
+						auto count = ((size_t)bytesRead / sizeof(input_event));
+
+						for (size_t i = 0; i < count; i++)
+						{
+							if (handle(device, events[i]))
+								reports++;
+						}
+
+						if (count < EVDEV_EVENT_BATCH)
+							break;
+					}
+
+					// Return the default response.
+					return true;
+				}
+
+				bool evdevDriver::handle(evdevDevice& device, const input_event& event)
+				{
+					switch (event.type)
+					{
+						case EV_SYN:
+							switch (event.code)
+							{
+								case SYN_DROPPED:
+									device.dropped = true;
+
+									break;
+								case SYN_REPORT:
+									if (device.dropped)
+									{
+										// Events were lost; ask the kernel for the whole state.
+										synchronize(device);
+									}
+									else
+									{
+										device.pending.timestamp.tv_sec = event.input_event_sec;
+										device.pending.timestamp.tv_usec = event.input_event_usec;
+
+										commit(device);
+									}
+
+									return true;
+							}
+
+							break;
+						case EV_KEY:
+							if (!device.dropped)
+								setButton(device, event.code, event.value);
+
+							break;
+						case EV_ABS:
+							if (!device.dropped)
+								setAxis(device, event.code, event.value);
+
+							break;
+					}
+
+					return false;
+				}
+
+				void evdevDriver::synchronize(evdevDevice& device)
+				{
+					// Local variable(s):
+					unsigned long keyBits[(KEY_MAX / BITS_PER_LONG) + 1];
+					timespec now;
+
+					ZeroVariable(keyBits);
+
+					ioctl(device.descriptor, EVIOCGKEY(sizeof(keyBits)), keyBits);
+
+					device.pending.buttons = 0;
+
+					for (unsigned int code = BTN_JOYSTICK; code < BTN_DIGI; code++)
+					{
+						setButton(device, code, (testBit(keyBits, code)) ? 1 : 0);
+					}
+
+					for (unsigned int code = BTN_DPAD_UP; code <= BTN_DPAD_RIGHT; code++)
+					{
+						setButton(device, code, (testBit(keyBits, code)) ? 1 : 0);
+					}
+
+					for (unsigned int code = 0; code < ABS_CNT; code++)
+					{
+						// Skip axes the device doesn't have.
+						if (device.axes[code].maximum == device.axes[code].minimum)
+							continue;
+
+						if (ioctl(device.descriptor, EVIOCGABS(code), &device.axes[code]) == 0)
+						{
+							setAxis(device, code, device.axes[code].value);
+						}
+					}
+
+					// There's no event to take a timestamp from, so use the current time.
+					clock_gettime(CLOCK_MONOTONIC, &now);
+
+					device.pending.timestamp.tv_sec = now.tv_sec;
+					device.pending.timestamp.tv_usec = (now.tv_nsec / 1000);
+
+					device.dropped = false;
+
+					commit(device);
+
+					return;
+				}
+
+				void evdevDriver::commit(evdevDevice& device)
+				{
+					device.pending.packetNumber = (device.report.packetNumber + 1);
+
+					if (device.pending.buttons != device.report.buttons)
+					{
+						// Make room by forgetting the oldest transition.
+						if (device.edgeCount == EVDEV_MAX_BUTTON_EDGES)
+						{
+							copy((device.edges + 1), (device.edges + EVDEV_MAX_BUTTON_EDGES), device.edges);
+
+							device.edgeCount--;
+						}
+
+						device.edges[device.edgeCount++] = { device.pending.buttons, device.pending.timestamp };
+					}
+
+					device.report = device.pending;
+
+					return;
+				}
+
+				void evdevDriver::setButton(evdevDevice& device, unsigned int code, int value)
+				{
+					// Local variable(s):
+					auto& pending = device.pending;
+
+					switch (code)
+					{
+						// Digital triggers are reported as fully pressed, or released.
+						case BTN_TL2:
+							if (!device.analogTriggers)
+								pending.leftTrigger = ((value != 0) ? UCHAR_MAX : 0);
+
+							return;
+						case BTN_TR2:
+							if (!device.analogTriggers)
+								pending.rightTrigger = ((value != 0) ? UCHAR_MAX : 0);
+
+							return;
+					}
+
+					// Local variable(s):
+					auto mask = buttonMask(code);
+
+					// Repeated presses are reported as '2'; treat them like any other press.
+					if (value != 0)
+						pending.buttons |= mask;
+					else
+						pending.buttons &= ~mask;
+
+					return;
+				}
+
+				void evdevDriver::setAxis(evdevDevice& device, unsigned int code, int value)
+				{
+					if (code >= ABS_CNT)
+						return;
+
+					// Local variable(s):
+					const auto& axis = device.axes[code];
+					auto& pending = device.pending;
+
+					switch (code)
+					{
+						case ABS_X:
+							pending.thumbLX = thumbValue(axis, value, false); break;
+						case ABS_Y:
+							pending.thumbLY = thumbValue(axis, value, true); break;
+						case ABS_RX:
+							pending.thumbRX = thumbValue(axis, value, false); break;
+						case ABS_RY:
+							pending.thumbRY = thumbValue(axis, value, true); break;
+
+						case ABS_Z:
+						case ABS_BRAKE:
+							pending.leftTrigger = triggerValue(axis, value); break;
+						case ABS_RZ:
+						case ABS_GAS:
+							pending.rightTrigger = triggerValue(axis, value); break;
+
+						case ABS_HAT0X:
+							setHat(pending.buttons, value, EVDEV_BUTTON_DPAD_LEFT, EVDEV_BUTTON_DPAD_RIGHT); break;
+						case ABS_HAT0Y:
+							setHat(pending.buttons, value, EVDEV_BUTTON_DPAD_UP, EVDEV_BUTTON_DPAD_DOWN); break;
+					}
+
+					return;
+				}
+			}
+		}
+	}
+#endif
\ No newline at end of file
@@ -0,0 +1,261 @@
+#pragma once
+
+// Preprocessor related:
+#define EVDEV_INPUT_DIRECTORY "/dev/input"
+#define EVDEV_DEVICE_PREFIX "event"
+
+// Devices with names starting with this are our own virtual devices, and are never detected.
+#define EVDEV_VIRTUAL_DEVICE_PREFIX "iosync-"
+
+// Includes:
+#include "../../../platform.h"
+
+// The 'GAMEPAD_EVDEV_ENABLED' preprocessor-variable should
+// only ever be defined when 'PLATFORM_LINUX' is defined.
+// Any other behavior should be considered non-standard.
+#if defined(PLATFORM_LINUX) && !defined(GAMEPAD_EXTERNAL_ORIGIN)
+	// Disable this if needed; toggles gamepad detection using evdev.
+	#define GAMEPAD_EVDEV_ENABLED
+#endif
+
+#ifdef GAMEPAD_EVDEV_ENABLED
+	// Linux-specific:
+	#include <linux/input.h>
+	#include <sys/time.h>
+
+	// Standard library:
+	#include <string>
+	#include <cstddef>
+
+	// Namespace(s):
+	namespace iosync
+	{
+		namespace devices
+		{
+			namespace evdev
+			{
+				// Namespace(s):
+				using namespace std;
+
+				// Enumerator(s):
+				enum evdevMetrics : unsigned int
+				{
+					// The most devices detected at once. (This matches XInput)
+					MAX_EVDEV_DEVICES = 4,
+
+					// The most events read from a device at once.
+					EVDEV_EVENT_BATCH = 64,
+
+					// The number of entries in 'gamepadButtonCodes'.
+					EVDEV_GAMEPAD_BUTTON_COUNT = 11,
+
+					// Identifies hot-plug notifications among the events 'epoll' reports; device events use their slot.
+					EVDEV_HOTPLUG_EVENT = MAX_EVDEV_DEVICES,
+
+					// The size of the buffer hot-plug notifications are read into.
+					EVDEV_HOTPLUG_BUFFER_SIZE = 4096,
+
+					// The most button transitions kept per device between calls to 'takeEdges'.
+					EVDEV_MAX_BUTTON_EDGES = 8,
+				};
+
+				// These match XInput's button layout, so detected states may be simulated anywhere.
+				enum evdevButtons : unsigned int
+				{
+					EVDEV_BUTTON_DPAD_UP = 0x0001,
+					EVDEV_BUTTON_DPAD_DOWN = 0x0002,
+					EVDEV_BUTTON_DPAD_LEFT = 0x0004,
+					EVDEV_BUTTON_DPAD_RIGHT = 0x0008,
+					EVDEV_BUTTON_START = 0x0010,
+					EVDEV_BUTTON_BACK = 0x0020,
+					EVDEV_BUTTON_LEFT_THUMB = 0x0040,
+					EVDEV_BUTTON_RIGHT_THUMB = 0x0080,
+					EVDEV_BUTTON_LEFT_SHOULDER = 0x0100,
+					EVDEV_BUTTON_RIGHT_SHOULDER = 0x0200,
+					EVDEV_BUTTON_GUIDE = 0x0400,
+					EVDEV_BUTTON_A = 0x1000,
+					EVDEV_BUTTON_B = 0x2000,
+					EVDEV_BUTTON_X = 0x4000,
+					EVDEV_BUTTON_Y = 0x8000,
+				};
+
+				// Global variable(s):
+
+				// The buttons of an XInput-layout device, other than its D-pad. (See 'buttonMask')
+				extern const unsigned short gamepadButtonCodes[EVDEV_GAMEPAD_BUTTON_COUNT];
+
+				// Functions:
+
+				// This maps a button's 'BTN_*' code to its XInput mask. (Zero if unmapped)
+				unsigned int buttonMask(unsigned int code);
+
+				// Structures:
+
+				// A complete report from a device, already converted to XInput's ranges.
+				struct evdevReport
+				{
+					// This is advanced with every report.
+					unsigned int packetNumber;
+
+					unsigned int buttons;
+
+					unsigned char leftTrigger;
+					unsigned char rightTrigger;
+
+					short thumbLX;
+					short thumbLY;
+					short thumbRX;
+					short thumbRY;
+
+					// When the kernel produced this report. (Using 'CLOCK_MONOTONIC', if the kernel allows it)
+					timeval timestamp;
+				};
+
+				// The buttons held after a transition, and when the kernel reported it.
+				struct evdevButtonEdge
+				{
+					unsigned int buttons;
+
+					timeval timestamp;
+				};
+
+				struct evdevDevice
+				{
+					// Fields:
+					string path;
+					string name;
+
+					// The ranges of each absolute axis, as reported by the kernel.
+					input_absinfo axes[ABS_CNT];
+
+					// The report being built from incoming events, and the last complete report.
+					evdevReport pending;
+					evdevReport report;
+
+					// Every change of buttons since the last call to 'takeEdges', oldest first.
+					evdevButtonEdge edges[EVDEV_MAX_BUTTON_EDGES];
+
+					size_t edgeCount = 0;
+
+					int descriptor = -1;
+
+					// Booleans / Flags:
+
+					// Set if the triggers are analog axes, rather than buttons.
+					bool analogTriggers = false;
+
+					// Set when the kernel drops events; incoming events are ignored until the next report.
+					bool dropped = false;
+
+					inline bool isOpen() const
+					{
+						return (descriptor >= 0);
+					}
+				};
+
+				// Classes:
+
+				/*
+					This detects gamepads using the kernel's "evdev" interface.
+
+					Joystick-class devices are found in '/dev/input', and are read without
+					blocking; every device is registered with one 'epoll' descriptor, so
+					polling costs one system-call when nothing has changed.
+
+					Events are collected until the kernel marks a complete report (SYN_REPORT);
+					only complete reports are visible through 'state'. If the kernel drops
+					events (SYN_DROPPED), the device's state is queried again instead.
+
+					The input directory is watched using 'inotify', which shares the same 'epoll'
+					descriptor; devices are added and removed as they're plugged in, and unplugged.
+				*/
+
+				class evdevDriver final
+				{
+					public:
+						// Functions:
+
+						// This specifies if the device 'descriptor' refers to is a joystick or gamepad.
+						static bool isGamepad(int descriptor);
+
+						// Constructor(s):
+						evdevDriver();
+
+						// Destructor(s):
+						~evdevDriver();
+
+						// Methods:
+						bool open();
+						void close();
+
+						inline bool isOpen() const
+						{
+							return (pollDescriptor >= 0);
+						}
+
+						// This opens any gamepads in 'directory' that aren't already open.
+						// The return value is the number of devices added.
+						size_t discover(const string& directory=EVDEV_INPUT_DIRECTORY);
+
+						// This reads every pending event, without blocking.
+						// The return value is the number of reports completed.
+						size_t poll();
+
+						inline bool connected(size_t slot) const
+						{
+							return (slot < MAX_EVDEV_DEVICES && devices[slot].isOpen());
+						}
+
+						// This outputs the last complete report from 'slot'.
+						// The return value indicates if 'slot' is connected.
+						bool state(size_t slot, evdevReport& report_out) const;
+
+						// This outputs (Then forgets) the button transitions 'slot' reported since the last call.
+						// Reports are only kept until the next poll, so this keeps presses shorter than a poll from being lost.
+						// The return value is the number of transitions written to 'edges_out'.
+						size_t takeEdges(size_t slot, evdevButtonEdge* edges_out, size_t maximum);
+
+						// Fields:
+						evdevDevice devices[MAX_EVDEV_DEVICES];
+					protected:
+						// Methods (Protected):
+						bool add(const string& path);
+						void remove(size_t slot);
+
+						// This finds the slot of the device at 'path'. ('MAX_EVDEV_DEVICES' if it isn't open)
+						size_t slotOf(const string& path) const;
+
+						// This starts watching 'directory' for devices being added, or removed.
+						bool watch(const string& directory);
+
+						// This handles any pending hot-plug notifications.
+						void readNotifications();
+
+						// This reads every pending event from 'device', adding the number of reports completed to 'reports'.
+						// The return value of this command indicates if the device is still connected.
+						bool read(evdevDevice& device, size_t& reports);
+
+						// The return value of this command indicates if 'event' completed a report.
+						bool handle(evdevDevice& device, const input_event& event);
+
+						// This rebuilds the state of 'device' by querying the kernel directly.
+						void synchronize(evdevDevice& device);
+
+						// This makes the pending report of 'device' visible through 'state'.
+						void commit(evdevDevice& device);
+
+						void setButton(evdevDevice& device, unsigned int code, int value);
+						void setAxis(evdevDevice& device, unsigned int code, int value);
+
+						// Fields (Protected):
+
+						// The directory being watched for hot-plug notifications.
+						string watchedDirectory;
+
+						int pollDescriptor = -1;
+						int notifyDescriptor = -1;
+				};
+			}
+		}
+	}
+#endif
\ No newline at end of file
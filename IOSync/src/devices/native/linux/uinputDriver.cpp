@@ -0,0 +1,228 @@
+// Includes:
+#include "uinputDriver.h"
+
+#ifdef GAMEPAD_UINPUT_ENABLED
+	// Linux-specific:
+	#include <sys/ioctl.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+
+	// Standard library:
+	#include <climits>
+	#include <cstring>
+	#include <cstdio>
+
+	// Namespace(s):
+	namespace iosync
+	{
+		namespace devices
+		{
+			namespace evdev
+			{
+				// Functions:
+
+				// Vertical axes are inverted, since XInput considers "up" to be positive.
+				// This is the exact inverse of how 'evdevDriver' reads them, so states survive a round-trip.
+				static inline int verticalValue(short value)
+				{
+					return (int)(~value);
+				}
+
+				static inline int hatValue(unsigned int buttons, unsigned int negative, unsigned int positive)
+				{
+					if ((buttons & negative) != 0)
+						return -1;
+
+					if ((buttons & positive) != 0)
+						return 1;
+
+					return 0;
+				}
+
+				static inline void setAxisRange(uinput_user_dev& device, unsigned int axis, int minimum, int maximum, int fuzz=0, int flat=0)
+				{
+					device.absmin[axis] = minimum;
+					device.absmax[axis] = maximum;
+					device.absfuzz[axis] = fuzz;
+					device.absflat[axis] = flat;
+
+					return;
+				}
+
+				// Classes:
+
+				// uinputGamepad:
+
+				// Constructor(s):
+				uinputGamepad::uinputGamepad()
+				{
+					ZeroVariable(last);
+				}
+
+				// Destructor(s):
+				uinputGamepad::~uinputGamepad()
+				{
+					destroy();
+				}
+
+				// Methods:
+				bool uinputGamepad::create(unsigned int index)
+				{
+					if (created())
+						return false;
+
+					descriptor = open(UINPUT_DEVICE_PATH, O_WRONLY|O_NONBLOCK|O_CLOEXEC);
+
+					if (descriptor < 0)
+					{
+						descriptor = open(UINPUT_DEVICE_PATH_ALT, O_WRONLY|O_NONBLOCK|O_CLOEXEC);
+
+						if (descriptor < 0)
+							return false;
+					}
+
+					ioctl(descriptor, UI_SET_EVBIT, EV_SYN);
+					ioctl(descriptor, UI_SET_EVBIT, EV_KEY);
+					ioctl(descriptor, UI_SET_EVBIT, EV_ABS);
+
+					for (auto code : gamepadButtonCodes)
+					{
+						ioctl(descriptor, UI_SET_KEYBIT, code);
+					}
+
+					for (auto axis : { ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ, ABS_HAT0X, ABS_HAT0Y })
+					{
+						ioctl(descriptor, UI_SET_ABSBIT, axis);
+					}
+
+					// Local variable(s):
+					uinput_user_dev device;
+
+					ZeroVariable(device);
+
+					snprintf(device.name, UINPUT_MAX_NAME_SIZE, UINPUT_GAMEPAD_NAME "%u", index);
+
+					device.id.bustype = BUS_USB;
+					device.id.vendor = UINPUT_GAMEPAD_VENDOR;
+					device.id.product = UINPUT_GAMEPAD_PRODUCT;
+					device.id.version = UINPUT_GAMEPAD_VERSION;
+
+					// These match the ranges of 'evdevReport'.
+					setAxisRange(device, ABS_X, SHRT_MIN, SHRT_MAX, UINPUT_THUMB_FUZZ, UINPUT_THUMB_FLAT);
+					setAxisRange(device, ABS_Y, SHRT_MIN, SHRT_MAX, UINPUT_THUMB_FUZZ, UINPUT_THUMB_FLAT);
+					setAxisRange(device, ABS_RX, SHRT_MIN, SHRT_MAX, UINPUT_THUMB_FUZZ, UINPUT_THUMB_FLAT);
+					setAxisRange(device, ABS_RY, SHRT_MIN, SHRT_MAX, UINPUT_THUMB_FUZZ, UINPUT_THUMB_FLAT);
+
+					setAxisRange(device, ABS_Z, 0, UCHAR_MAX);
+					setAxisRange(device, ABS_RZ, 0, UCHAR_MAX);
+
+					setAxisRange(device, ABS_HAT0X, -1, 1);
+					setAxisRange(device, ABS_HAT0Y, -1, 1);
+
+					if (write(descriptor, &device, sizeof(device)) != (ssize_t)sizeof(device) || ioctl(descriptor, UI_DEV_CREATE) < 0)
+					{
+						close(descriptor);
+
+						descriptor = -1;
+
+						return false;
+					}
+
+					hasState = false;
+
+					// Return the default response.
+					return true;
+				}
+
+				void uinputGamepad::destroy()
+				{
+					if (!created())
+						return;
+
+					// Tell the system we're disconnecting the device.
+					ioctl(descriptor, UI_DEV_DESTROY);
+
+					close(descriptor);
+
+					descriptor = -1;
+
+					return;
+				}
+
+				bool uinputGamepad::apply(const evdevReport& state)
+				{
+					if (!created())
+						return false;
+
+					// Local variable(s):
+					input_event events[UINPUT_MAX_STATE_EVENTS];
+
+					size_t count = 0;
+
+					ZeroVariable(events);
+
+					auto add = [&events, &count](unsigned short type, unsigned short code, int value)
+					{
+						events[count].type = type;
+						events[count].code = code;
+						events[count].value = value;
+
+						count++;
+					};
+
+					auto changedButtons = (hasState) ? (state.buttons ^ last.buttons) : UINT_MAX;
+
+					for (auto code : gamepadButtonCodes)
+					{
+						auto mask = buttonMask(code);
+
+						if ((changedButtons & mask) != 0)
+							add(EV_KEY, code, ((state.buttons & mask) != 0) ? 1 : 0);
+					}
+
+					if (!hasState || state.thumbLX != last.thumbLX)
+						add(EV_ABS, ABS_X, state.thumbLX);
+
+					if (!hasState || state.thumbLY != last.thumbLY)
+						add(EV_ABS, ABS_Y, verticalValue(state.thumbLY));
+
+					if (!hasState || state.thumbRX != last.thumbRX)
+						add(EV_ABS, ABS_RX, state.thumbRX);
+
+					if (!hasState || state.thumbRY != last.thumbRY)
+						add(EV_ABS, ABS_RY, verticalValue(state.thumbRY));
+
+					if (!hasState || state.leftTrigger != last.leftTrigger)
+						add(EV_ABS, ABS_Z, state.leftTrigger);
+
+					if (!hasState || state.rightTrigger != last.rightTrigger)
+						add(EV_ABS, ABS_RZ, state.rightTrigger);
+
+					if ((changedButtons & (EVDEV_BUTTON_DPAD_LEFT | EVDEV_BUTTON_DPAD_RIGHT)) != 0)
+						add(EV_ABS, ABS_HAT0X, hatValue(state.buttons, EVDEV_BUTTON_DPAD_LEFT, EVDEV_BUTTON_DPAD_RIGHT));
+
+					if ((changedButtons & (EVDEV_BUTTON_DPAD_UP | EVDEV_BUTTON_DPAD_DOWN)) != 0)
+						add(EV_ABS, ABS_HAT0Y, hatValue(state.buttons, EVDEV_BUTTON_DPAD_UP, EVDEV_BUTTON_DPAD_DOWN));
+
+					// Nothing changed, so there's nothing to report.
+					if (count == 0)
+						return true;
+
+					add(EV_SYN, SYN_REPORT, 0);
+
+					// Every event is written at once, so the state costs a single system-call.
+					auto bytes = (ssize_t)(count * sizeof(input_event));
+
+					if (write(descriptor, events, (size_t)bytes) != bytes)
+						return false;
+
+					last = state;
+					hasState = true;
+
+					// Return the default response.
+					return true;
+				}
+			}
+		}
+	}
+#endif
\ No newline at end of file
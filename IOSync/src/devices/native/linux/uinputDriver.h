@@ -0,0 +1,102 @@
+#pragma once
+
+// Preprocessor related:
+#define UINPUT_DEVICE_PATH "/dev/uinput"
+#define UINPUT_DEVICE_PATH_ALT "/dev/input/uinput"
+
+// Virtual devices are named with this, followed by their index. (See 'EVDEV_VIRTUAL_DEVICE_PREFIX')
+#define UINPUT_GAMEPAD_NAME "iosync-virtual-gamepad-"
+
+// Includes:
+#include "evdevDriver.h"
+
+// The 'GAMEPAD_UINPUT_ENABLED' preprocessor-variable should
+// only ever be defined when 'GAMEPAD_EVDEV_ENABLED' is defined.
+#ifdef GAMEPAD_EVDEV_ENABLED
+	// Disable this if needed; toggles gamepad simulation using uinput.
+	#define GAMEPAD_UINPUT_ENABLED
+#endif
+
+#ifdef GAMEPAD_UINPUT_ENABLED
+	// Linux-specific:
+	#include <linux/uinput.h>
+
+	// Namespace(s):
+	namespace iosync
+	{
+		namespace devices
+		{
+			namespace evdev
+			{
+				// Enumerator(s):
+				enum uinputMetrics : unsigned int
+				{
+					// Identifies virtual devices as wired Xbox 360 controllers, so applications expect XInput's layout.
+					UINPUT_GAMEPAD_VENDOR = 0x045E,
+					UINPUT_GAMEPAD_PRODUCT = 0x028E,
+					UINPUT_GAMEPAD_VERSION = 1,
+
+					// Used by the kernel to filter noise from the thumb-sticks.
+					UINPUT_THUMB_FUZZ = 16,
+					UINPUT_THUMB_FLAT = 128,
+
+					// The most events a single state can produce; every axis and button, then 'SYN_REPORT'.
+					UINPUT_MAX_STATE_EVENTS = (EVDEV_GAMEPAD_BUTTON_COUNT + 8 + 1),
+				};
+
+				// Classes:
+
+				/*
+					This is a virtual XInput-layout gamepad, created using the kernel's "uinput" interface.
+
+					Every state applied is compared against the last one; only the events that
+					changed are written, followed by 'SYN_REPORT', using a single system-call.
+					States use the same ranges as 'evdevReport', so detected states may be
+					simulated without any loss.
+				*/
+
+				class uinputGamepad final
+				{
+					public:
+						// Constructor(s):
+						uinputGamepad();
+
+						uinputGamepad(const uinputGamepad&) = delete;
+
+						// Destructor(s):
+						~uinputGamepad();
+
+						// Methods:
+
+						// The return value of this command indicates if the device was created.
+						bool create(unsigned int index);
+
+						void destroy();
+
+						inline bool created() const
+						{
+							return (descriptor >= 0);
+						}
+
+						// The return value of this command indicates if the device was updated. (Unchanged states count as updated)
+						bool apply(const evdevReport& state);
+
+						// Operator(s):
+						uinputGamepad& operator=(const uinputGamepad&) = delete;
+					protected:
+						// Fields (Protected):
+
+						// The last state applied; used to find which events to write.
+						evdevReport last;
+
+						int descriptor = -1;
+
+						// Booleans / Flags:
+
+						// Set once a state has been applied; until then, every event is written.
+						bool hasState = false;
+				};
+			}
+		}
+	}
+#endif
\ No newline at end of file
@@ -0,0 +1,297 @@
+#pragma once
+
+// Includes:
+#include "../platform.h"
+
+// Platform-specific:
+#ifndef PLATFORM_WINDOWS
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+#endif
+
+// Standard library:
+#include <atomic>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// Namespace(s):
+namespace iosync
+{
+	namespace devices
+	{
+		// Enumerator(s):
+		enum sharedMemoryState
+		{
+			SHARED_MEMORY_UNAVAILABLE,
+			SHARED_MEMORY_ALREADY_ALLOCATED,
+			SHARED_MEMORY_ALLOCATED,
+		};
+
+		enum sharedMemoryMetrics : unsigned int
+		{
+			// The number of times a reader retries a slot that's being written, before giving up.
+			SHARED_MEMORY_READ_ATTEMPTS = 64,
+		};
+
+		// Structures:
+
+		// A single state published through a 'sharedStateSegment'.
+		template <typename stateType>
+		struct sharedStateSlot
+		{
+			// This is odd while 'state' is being written, and advances by two with every state published.
+			std::atomic<std::uint32_t> sequence;
+
+			stateType state;
+		};
+
+		// The layout of a shared memory segment; this is the same for every process mapping it.
+		template <typename stateType, std::size_t slotCount>
+		struct sharedStateSegment
+		{
+			std::atomic<bool> pluggedIn[slotCount];
+
+			sharedStateSlot<stateType> slots[slotCount];
+		};
+
+		// Classes:
+
+		/*
+			This maps a named segment of memory, shared between processes, holding 'slotCount' states.
+
+			The segment is mapped once, and stays mapped until 'close' is called.
+			One process publishes states, and any number of processes read them.
+
+			Each slot is published using a sequence lock; the writer marks the
+			slot as being written, copies the state, then marks it as complete.
+			Readers copy the state without locking, then retry if it changed while copying.
+			This way, readers never see a partially written ("torn") state.
+
+			Windows uses a named file mapping; other platforms use POSIX shared memory.
+			With POSIX shared memory, 'name' must begin with a slash.
+		*/
+
+		template <typename stateType, std::size_t slotCount>
+		class sharedStateMemory
+		{
+			public:
+				// Typedefs:
+				typedef sharedStateSegment<stateType, slotCount> segment;
+
+				// Constructor(s):
+				sharedStateMemory(const char* name) : name(name) { /* Nothing so far. */ }
+
+				// Destructor(s):
+				~sharedStateMemory()
+				{
+					close();
+				}
+
+				// Methods:
+
+				// This maps the named segment, creating it if it doesn't exist yet.
+				sharedMemoryState open()
+				{
+					// Local variable(s):
+					auto response = SHARED_MEMORY_ALREADY_ALLOCATED;
+
+					if (isOpen())
+						return response;
+
+					#ifdef PLATFORM_WINDOWS
+						handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+
+						if (handle == NULL)
+						{
+							handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)sizeof(segment), name);
+
+							if (handle == NULL)
+								return SHARED_MEMORY_UNAVAILABLE;
+
+							response = SHARED_MEMORY_ALLOCATED;
+						}
+
+						memory = (segment*)MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(segment));
+
+						if (memory == nullptr)
+						{
+							CloseHandle(handle);
+
+							handle = NULL;
+
+							return SHARED_MEMORY_UNAVAILABLE;
+						}
+					#else
+						auto descriptor = shm_open(name, O_RDWR, 0);
+
+						if (descriptor < 0)
+						{
+							if (errno != ENOENT)
+								return SHARED_MEMORY_UNAVAILABLE;
+
+							descriptor = shm_open(name, (O_RDWR | O_CREAT | O_EXCL), (S_IRUSR | S_IWUSR));
+
+							if (descriptor < 0)
+								return SHARED_MEMORY_UNAVAILABLE;
+
+							// New segments are zero-filled, so every slot starts unplugged, and not being written.
+							if (ftruncate(descriptor, sizeof(segment)) != 0)
+							{
+								::close(descriptor);
+
+								shm_unlink(name);
+
+								return SHARED_MEMORY_UNAVAILABLE;
+							}
+
+							response = SHARED_MEMORY_ALLOCATED;
+						}
+
+						auto mapping = mmap(nullptr, sizeof(segment), (PROT_READ | PROT_WRITE), MAP_SHARED, descriptor, 0);
+
+						// The mapping stays valid after the descriptor is closed.
+						::close(descriptor);
+
+						if (mapping == MAP_FAILED)
+						{
+							if (response == SHARED_MEMORY_ALLOCATED)
+								shm_unlink(name);
+
+							return SHARED_MEMORY_UNAVAILABLE;
+						}
+
+						memory = (segment*)mapping;
+					#endif
+
+					owner = (response == SHARED_MEMORY_ALLOCATED);
+
+					return response;
+				}
+
+				bool close()
+				{
+					if (!isOpen())
+						return false;
+
+					#ifdef PLATFORM_WINDOWS
+						UnmapViewOfFile(memory);
+						CloseHandle(handle);
+
+						handle = NULL;
+					#else
+						munmap(memory, sizeof(segment));
+
+						// POSIX segments outlive their processes, so the creator removes its name.
+						if (owner)
+							shm_unlink(name);
+					#endif
+
+					memory = nullptr;
+					owner = false;
+
+					// Return the default response.
+					return true;
+				}
+
+				inline bool isOpen() const
+				{
+					return (memory != nullptr);
+				}
+
+				inline void setPluggedIn(std::size_t slot, bool value)
+				{
+					if (!isOpen() || slot >= slotCount)
+						return;
+
+					memory->pluggedIn[slot].store(value, std::memory_order_release);
+
+					return;
+				}
+
+				inline bool pluggedIn(std::size_t slot) const
+				{
+					if (!isOpen() || slot >= slotCount)
+						return false;
+
+					return memory->pluggedIn[slot].load(std::memory_order_acquire);
+				}
+
+				// This publishes 'state' to 'slot'. Only one process should publish to a slot.
+				void publish(std::size_t slot, const stateType& state)
+				{
+					if (!isOpen() || slot >= slotCount)
+						return;
+
+					// Local variable(s):
+					auto& entry = memory->slots[slot];
+					auto sequence = entry.sequence.load(std::memory_order_relaxed);
+
+					// Mark the slot as being written, before the state changes.
+					entry.sequence.store((sequence + 1), std::memory_order_relaxed);
+
+					std::atomic_thread_fence(std::memory_order_release);
+
+					std::memcpy(&entry.state, &state, sizeof(stateType));
+
+					// Mark the slot as complete, after the state has changed.
+					entry.sequence.store((sequence + 2), std::memory_order_release);
+
+					return;
+				}
+
+				/*
+					This takes a consistent snapshot of 'slot', without locking.
+					The return value indicates if a snapshot was taken; this fails if
+					the slot was being written for every one of our attempts.
+				*/
+
+				bool read(std::size_t slot, stateType& state_out) const
+				{
+					if (!isOpen() || slot >= slotCount)
+						return false;
+
+					// Local variable(s):
+					const auto& entry = memory->slots[slot];
+
+					for (unsigned int attempt = 0; attempt < SHARED_MEMORY_READ_ATTEMPTS; attempt++)
+					{
+						auto before = entry.sequence.load(std::memory_order_acquire);
+
+						// The writer is in the middle of this slot.
+						if ((before & 1) != 0)
+							continue;
+
+						std::memcpy(&state_out, &entry.state, sizeof(stateType));
+
+						std::atomic_thread_fence(std::memory_order_acquire);
+
+						if (entry.sequence.load(std::memory_order_relaxed) == before)
+							return true;
+					}
+
+					return false;
+				}
+
+				// Fields:
+
+				// The name of the segment; shared between every process mapping it.
+				const char* name;
+			protected:
+				// Fields (Protected):
+				segment* memory = nullptr;
+
+				#ifdef PLATFORM_WINDOWS
+					HANDLE handle = NULL;
+				#endif
+
+				// Booleans / Flags:
+
+				// Set if this object created the segment.
+				bool owner = false;
+		};
+	}
+}
\ No newline at end of file
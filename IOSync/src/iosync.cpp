@@ -6,6 +6,7 @@
 #include <sstream>
 #include <exception>
 #include <stdexcept>
+#include <thread>
 
 // Windows API:
 #ifdef PLATFORM_WINDOWS
@@ -182,10 +183,11 @@ namespace iosync
 			bool kbdEnabled,
 			bool gpdsEnabled,
 			unsigned char max_gpds
-		) : deviceConfiguration(kbdEnabled, gpdsEnabled, max_gpds), keyboard(nullptr), gamepadTimeout(gpTimeout)
+		) : deviceConfiguration(kbdEnabled, gpdsEnabled, max_gpds), keyboard(nullptr), gamepads(max((size_t)max_gpds, (size_t)MAX_GAMEPADS)),
+			gamepadTimeout(gpTimeout), heartbeatInterval((milliseconds)GAMEPAD_DEFAULT_HEARTBEAT_INTERVAL), heartbeatSnapshot(high_resolution_clock::now()),
+			gamepadSendSnapshot(high_resolution_clock::now()), keyboardSendSnapshot(high_resolution_clock::now())
 		{
-			for (auto i = 0; i < MAX_GAMEPADS; i++)
-				gamepads[i] = nullptr;
+			// Nothing so far.
 		}
 
 		// Destructor(s):
@@ -213,11 +215,11 @@ namespace iosync
 
 			if (checkArray)
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					if (gamepads[i] == pad)
 					{
-						gamepads[i] = nullptr;
+						gamepads.remove(i);
 
 						break;
 					}
@@ -233,7 +235,7 @@ namespace iosync
 		{
 			deviceInfo << "Attempting to destroy gamepad device-instance..." << endl;
 
-			destroyGamepad(gamepads[identifier], false); gamepads[identifier] = nullptr;
+			destroyGamepad(gamepads.remove(identifier), false);
 
 			deviceInfo << "Device-instance destroyed." << endl;
 
@@ -246,6 +248,8 @@ namespace iosync
 			updateKeyboard(program);
 			updateGamepads(program);
 
+			checkGamepadSilence();
+
 			return;
 		}
 
@@ -259,6 +263,19 @@ namespace iosync
 
 		void connectedDevices::updateGamepads(iosync_application* program)
 		{
+			#ifdef GAMEPAD_EVDEV_ENABLED
+				/*
+					Read input, and hot-plug notifications for every real device at once.
+					Devices are added and removed here, as they're plugged in and unplugged,
+					so the checks below only read the state this leaves behind.
+				*/
+
+				if (gamepadsEnabled)
+				{
+					gp::__linux__pollDevices();
+				}
+			#endif
+
 			#if defined(IOSYNC_DEVICE_GAMEPAD) && defined(IOSYNC_DEVICE_GAMEPAD_AUTODETECT)
 				// Local variable(s):
 				bool connectedToNetwork = program->network->connectedToOthers();
@@ -268,8 +285,8 @@ namespace iosync
 				{
 					if (gamepadsEnabled)
 					{
-						// Check for state changes:
-						for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+						// Check for state changes; only the first slots can have real devices:
+						for (gamepadID i = 0; i < MAX_GAMEPADS && i < gamepads.capacity(); i++)
 						{
 							bool connected = gamepadConnected(i);
 
@@ -307,8 +324,8 @@ namespace iosync
 											break;
 									}
 
-									// Add this identifier, so we don't bother trying to connect with it redundantly.
-									reservedGamepads.insert(i);
+									// Reserve this identifier, so we don't bother trying to connect with it redundantly.
+									gamepads.reserve(i);
 								}
 							}
 							else
@@ -322,8 +339,8 @@ namespace iosync
 										// Disconnection was successful, tell the remote host.
 										sendGamepadDisconnectMessage(*program->network, program->network->socket, i, (program->multiWayOperations()) ? DESTINATION_ALL : DESTINATION_HOST);
 
-										// Remove this identifier, so it may be used again.
-										reservedGamepads.erase(i);
+										// Release this identifier, so it may be used again.
+										gamepads.unreserve(i);
 									}
 								}
 							}
@@ -332,9 +349,9 @@ namespace iosync
 				}
 			#endif
 
-			for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+			for (gamepadID i = 0; i < gamepads.capacity(); i++)
 			{
-				if (gamepadConnected(i))
+				if (gamepads.connected(i))
 				{
 					//cout << "gamepads["<<i<<"]->canDetect(): " << gamepads[i]->canDetect() << ", gamepads["<<i<<"]->canSimulate(): " << gamepads[i]->canSimulate() << endl;
 
@@ -344,7 +361,7 @@ namespace iosync
 					}
 					else
 					{
-						if (gamepads[i]->canDetect())
+						if (gamepads.detects(i))
 						{
 							gamepads[i]->detect(*program);
 						}
@@ -355,6 +372,28 @@ namespace iosync
 			return;
 		}
 
+		void connectedDevices::sampleGamepads(iosync_application* program)
+		{
+			// Hosts of multi-way sessions log the states they detect by frame, so they're only sampled with each update.
+			if (!gamepadsEnabled || !program->allowDeviceDetection() || program->multiWayHost())
+				return;
+
+			#ifdef GAMEPAD_EVDEV_ENABLED
+				gp::__linux__pollDevices();
+			#endif
+
+			// Only the newest state is kept; button transitions between samples are kept by each gamepad's 'buttonCoalescer'.
+			for (gamepadID i = 0; i < gamepads.capacity(); i++)
+			{
+				if (gamepads.connected(i) && gamepads.detects(i))
+				{
+					gamepads[i]->detect(*program);
+				}
+			}
+
+			return;
+		}
+
 		void connectedDevices::connect(iosync_application* program)
 		{
 			// Connect all devices:
@@ -388,6 +427,10 @@ namespace iosync
 
 		void connectedDevices::onGamepadConnected(iosync_application* program, gp* pad)
 		{
+			pad->conditioning = gamepadInputConditioning;
+			pad->maximumLatency = gamepadMaximumLatency;
+			pad->reconstruction = gamepadOutputReconstruction;
+
 			#ifdef PLATFORM_WINDOWS
 				if (pad->canSimulate() && this->vJoyEnabled)
 				{
@@ -429,10 +472,26 @@ namespace iosync
 					#endif
 
 					// Ensure shared memory is "open".
-					gp::__winnt__autoOpenSharedMemory();
+					gp::autoOpenSharedMemory();
 
 					// Activate the virtual gamepad.
-					gp::__winnt__activateGamepad(pad->localGamepadNumber);
+					gp::activateGamepad(pad->localGamepadNumber);
+				}
+			#else
+				if (pad->canSimulate())
+				{
+					#ifdef GAMEPAD_UINPUT_ENABLED
+						// Simulate states natively, using a virtual device.
+						if (!pad->__linux__uinputDevice.create((unsigned int)pad->localGamepadNumber))
+						{
+							deviceInfo << "Unable to create a virtual gamepad; is '" << UINPUT_DEVICE_PATH << "' writable?" << endl;
+						}
+					#endif
+
+					// Publish simulated states through shared memory.
+					gp::autoOpenSharedMemory();
+
+					gp::activateGamepad(pad->localGamepadNumber);
 				}
 			#endif
 
@@ -444,7 +503,7 @@ namespace iosync
 			#ifdef PLATFORM_WINDOWS
 				if (pad->canSimulate() && this->vJoyEnabled)
 				{
-					gp::__winnt__deactivateGamepad(pad->localGamepadNumber);
+					gp::deactivateGamepad(pad->localGamepadNumber);
 
 					// Local variable(s):
 					bool hasPadConnected = hasGamepadConnected();
@@ -472,7 +531,19 @@ namespace iosync
 					// We don't have any gamepads connected,
 					// close the shared memory segment:
 					if (!hasPadConnected)
-						gp::__winnt__closeSharedMemory();
+						gp::closeSharedMemory();
+				}
+			#else
+				if (pad->canSimulate())
+				{
+					gp::deactivateGamepad(pad->localGamepadNumber);
+
+					#ifdef GAMEPAD_UINPUT_ENABLED
+						pad->__linux__uinputDevice.destroy();
+					#endif
+
+					if (!hasGamepadConnected())
+						gp::closeSharedMemory();
 				}
 			#endif
 
@@ -485,6 +556,8 @@ namespace iosync
 
 			if (gamepads[identifier]->disconnect())
 			{
+				gamepads.refresh(identifier);
+
 				// Execute the gamepad disconnection call-back.
 				onGamepadDisconnected(program, gamepads[identifier]);
 
@@ -501,15 +574,11 @@ namespace iosync
 		// To use a local/"real" identifier, please use 'disconnectLocalGamepad'.
 		bool connectedDevices::disconnectGamepad(iosync_application* program, gamepadID identifier)
 		{
-			for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
-			{
-				if (!gamepadConnected(i))
-					continue;
+			auto i = gamepads.findRemote(identifier);
 
-				if (gamepads[i]->remoteGamepadNumber == identifier)
-				{
-					return disconnectLocalGamepad(program, i); // gamepads[i]->localGamepadNumber;
-				}
+			if (i != GAMEPAD_ID_NONE)
+			{
+				return disconnectLocalGamepad(program, i); // gamepads[i]->localGamepadNumber;
 			}
 
 			// Return the default response.
@@ -571,6 +640,14 @@ namespace iosync
 				return nullptr;
 			}
 
+			// Make sure the identifier fits in the 'gamepads' table:
+			if (identifier >= gamepads.capacity())
+			{
+				deviceInfo << "Unable to create gamepad-instance; identifier out of range: " << identifier << endl;
+
+				return nullptr;
+			}
+
 			// Check if we need to create a new 'gp' object:
 			if (gamepads[identifier] == nullptr)
 			{
@@ -579,7 +656,7 @@ namespace iosync
 				auto realPluggedIn = gp::realDeviceConnected(identifier);
 
 				// Allocate a new 'gp' on the heap.
-				gamepads[identifier] = new gp
+				gamepads.insert(identifier, new gp
 				(
 					identifier, remoteIdentifier,
 					program->allowDeviceDetection()
@@ -596,7 +673,7 @@ namespace iosync
 						// If the real gamepad is connected, don't allow simulation.
 						&& (!realPluggedIn || program->multiWayOperations())
 					#endif
-				);
+				));
 
 				deviceInfo << "Gamepad-instance created." << endl;
 			}
@@ -623,6 +700,8 @@ namespace iosync
 				return nullptr;
 			}
 
+			gamepads.refresh(identifier);
+
 			onGamepadConnected(program, gamepads[identifier]);
 
 			deviceInfo << "Gamepad connected." << endl;
@@ -722,7 +801,7 @@ namespace iosync
 							{
 								if (program->allowDeviceDetection())
 								{
-									reservedGamepads.erase(identifier);
+									gamepads.unreserve(identifier);
 								}
 
 								sendGamepadDisconnectMessage(*program->network, socket, identifier, DESTINATION_REPLY);
@@ -738,7 +817,7 @@ namespace iosync
 								return false;
 							}
 
-							pad->owner = program->network->getPlayer(socket);
+							gamepads.setOwner(pad->localGamepadNumber, program->network->getPlayer(socket));
 
 							//if (program->allowDeviceSimulation()) // !program->multiWayOperations()
 							//if (program->mode == iosync_application::MODE_SERVER || program->mode == iosync_application::MODE_DIRECT_SERVER)
@@ -757,7 +836,7 @@ namespace iosync
 								return false;
 							}
 
-							pad->owner = program->network->getPlayer(socket);
+							gamepads.setOwner(pad->localGamepadNumber, program->network->getPlayer(socket));
 
 							//if (program->allowDeviceSimulation())
 							if (program->network->isHostNode)
@@ -801,7 +880,7 @@ namespace iosync
 
 							if (program->allowDeviceDetection() && !remoteGamepadConnected(identifier))
 							{
-								reservedGamepads.insert(identifier);
+								gamepads.reserve(identifier);
 
 								return true; // false;
 							}
@@ -836,6 +915,116 @@ namespace iosync
 			return true;
 		}
 
+		// Subscription related:
+		subscriptionChannels connectedDevices::deviceChannel(deviceType devType, gamepadID identifier)
+		{
+			switch (devType)
+			{
+				case DEVICE_TYPE_KEYBOARD:
+					return 1;
+				case DEVICE_TYPE_GAMEPAD:
+					if (identifier < SUBSCRIPTION_GAMEPAD_CHANNELS)
+					{
+						return ((subscriptionChannels)1 << (identifier + 1));
+					}
+
+					break;
+			}
+
+			// We can't narrow this down; route to everyone.
+			return SUBSCRIPTION_CHANNELS_ALL;
+		}
+
+		subscriptionChannels connectedDevices::parseSubscriptions(const wstring& devicesList)
+		{
+			// Local variable(s):
+			subscriptionChannels channels = 0;
+
+			wstringstream ss(devicesList);
+			wstring entry;
+
+			while (getline(ss, entry, L','))
+			{
+				// Trim the whitespace around this entry:
+				auto first = entry.find_first_not_of(L" \t");
+
+				if (first == wstring::npos)
+					continue;
+
+				entry = entry.substr(first, (entry.find_last_not_of(L" \t") - first) + 1);
+
+				if (entry == L"keyboard")
+				{
+					channels |= deviceChannel(DEVICE_TYPE_KEYBOARD);
+
+					continue;
+				}
+
+				try
+				{
+					channels |= deviceChannel(DEVICE_TYPE_GAMEPAD, (gamepadID)stoul(entry));
+				}
+				catch (std::invalid_argument&)
+				{
+					clog << "Unknown device in subscription list: " << wideStringToDefault(entry) << endl;
+				}
+			}
+
+			// Without any valid entries, we subscribe to everything.
+			if (channels == 0)
+				return SUBSCRIPTION_CHANNELS_ALL;
+
+			return channels;
+		}
+
+		wstring connectedDevices::encodeSubscriptions(subscriptionChannels channels)
+		{
+			// Local variable(s):
+			wstringstream ss;
+
+			if ((channels & deviceChannel(DEVICE_TYPE_KEYBOARD)) != 0)
+				ss << L"keyboard";
+
+			for (gamepadID i = 0; i < SUBSCRIPTION_GAMEPAD_CHANNELS; i++)
+			{
+				if ((channels & deviceChannel(DEVICE_TYPE_GAMEPAD, i)) != 0)
+				{
+					if (ss.tellp() > 0)
+						ss << L", ";
+
+					ss << (unsigned)i;
+				}
+			}
+
+			return ss.str();
+		}
+
+		subscriptionChannels connectedDevices::parseDeviceMessageChannels(QSocket& socket)
+		{
+			// Local variable(s):
+			auto devType = socket.read<deviceType>();
+			auto subMessageType = socket.read<deviceMessageType>();
+
+			if (!isStateMessage(subMessageType))
+				return SUBSCRIPTION_CHANNELS_ALL;
+
+			switch (devType)
+			{
+				case DEVICE_TYPE_KEYBOARD:
+					return deviceChannel(devType);
+				case DEVICE_TYPE_GAMEPAD:
+					// Check if this message uses header-extensions:
+					if (socket.readBool())
+					{
+						return deviceChannel(devType, (gamepadID)socket.read<serializedGamepadID>());
+					}
+
+					break;
+			}
+
+			return SUBSCRIPTION_CHANNELS_ALL;
+		}
+
 		headerInfo connectedDevices::beginDeviceMessage(networkEngine& engine, QSocket& socket, deviceType devType)
 		{
 			headerInfo info = engine.beginMessage(socket, iosync_application::MESSAGE_TYPE_DEVICE);
@@ -848,7 +1037,8 @@ namespace iosync
 		// Serialization related:
 		void connectedDevices::serializeTo(networkEngine& engine, QSocket& socket)
 		{
-			if (keyboardConnected())
+			// Only send keyboard messages when there's something to send.
+			if (keyboardConnected() && keyboard->hasAction())
 				serializeKeyboard(engine, socket);
 
 			// Serialize every connected 'gamepad'.
@@ -879,6 +1069,17 @@ namespace iosync
 			return;
 		}
 
+		void connectedDevices::serializeGamepadHeartbeat(networkEngine& engine, QSocket& socket, gamepadID gamepadLocation, gamepadID remoteIdentifier)
+		{
+			auto headerInformation = beginGamepadDeviceMessage(engine, socket, remoteIdentifier, DEVICE_NETWORK_MESSAGE_HEARTBEAT);
+
+			gamepads[gamepadLocation]->writeHeartbeatTo(socket);
+
+			engine.finishMessage(socket, headerInformation);
+
+			return;
+		}
+
 		void connectedDevices::serializeConnectMessage(QSocket& socket, deviceType device)
 		{
 			// Mark this message as non-extension based.
@@ -1148,6 +1349,10 @@ namespace iosync
 					case DEVICE_NETWORK_MESSAGE_ENTRIES:
 						parseIODevice(program, socket, pad, header, footer);
 
+						break;
+					case DEVICE_NETWORK_MESSAGE_HEARTBEAT:
+						pad->readHeartbeatFrom(socket);
+
 						break;
 					default:
 						// This sub-message type is unsupported, skip it.
@@ -1183,11 +1388,11 @@ namespace iosync
 			{
 				if (gamepadsEnabled)
 				{
-					for (gamepadID i = 0; i < deviceManagement::MAX_GAMEPADS; i++)
+					for (gamepadID i = 0; i < gamepads.capacity(); i++)
 					{
-						if (gamepadConnected(i))
+						if (gamepads.connected(i))
 						{
-							sent += engine.sendMessage(socket, generateGamepadExistsMessage(engine, socket, gamepads[i]->remoteGamepadNumber, p, p.vaddr()));
+							sent += engine.sendMessage(socket, generateGamepadExistsMessage(engine, socket, gamepads.remoteIdentifier(i), p, p.vaddr()));
 						}
 					}
 				}
@@ -1208,26 +1413,103 @@ namespace iosync
 			return engine.sendMessage(engine, destination);
 		}
 
-		size_t connectedDevices::reliableSendTo(networkEngine& engine, networkDestinationCode destination)
+		size_t connectedDevices::reliableSendTo(networkEngine& engine, networkDestinationCode destination, bool sampling)
 		{
 			size_t sent = 0;
 
-			if (keyboardConnected())
+			// Only send keyboard messages when there's something to send.
+			// Actions are queued until they're sent, so a lower send-rate only batches them.
+			if (keyboardConnected() && keyboard->hasAction() && sendDue(keyboardSendRate, keyboardSendSnapshot, sampling))
 			{
 				sent += engine.sendMessage(engine, generateKeyboardState(engine, engine), destination);
 			}
 
-			for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+			// States are kept until they're sent, so gamepads that aren't due now are sent later.
+			bool gamepadsDue = sendDue(gamepadSendRate, gamepadSendSnapshot, sampling);
+
+			for (gamepadID i = 0; gamepadsDue && i < gamepads.capacity(); i++)
 			{
-				if (gamepadConnected(i) && gamepads[i]->canDetect() && gamepads[i]->hasRealState()) // gamepads[i]->canSimulate() || hasState()
+				if (gamepads.connected(i) && gamepads.detects(i) && gamepads[i]->hasRealState()) // gamepads[i]->canSimulate() || hasState()
 				{
-					sent += engine.sendMessage(engine, generateGamepadState(engine, engine, i, gamepads[i]->remoteGamepadNumber), destination);
+					auto packet = generateGamepadState(engine, engine, i, gamepads.remoteIdentifier(i));
+
+					// Let the gamepad know which packet carries its state, so it can track confirmation.
+					gamepads[i]->onStateSent(packet.identifier);
+
+					sent += engine.sendMessage(engine, packet, destination);
 				}
 			}
 
+			sent += sendHeartbeats(engine, destination);
+
 			return sent;
 		}
 
+		bool connectedDevices::sendDue(rate sendRate, high_resolution_clock::time_point& snapshot, bool sampling)
+		{
+			if (sendRate == 0)
+				return !sampling;
+
+			if (high_resolution_clock::now() - snapshot < (microseconds)(1000000 / sendRate))
+				return false;
+
+			snapshot = high_resolution_clock::now();
+
+			// Return the default response.
+			return true;
+		}
+
+		size_t connectedDevices::sendHeartbeats(networkEngine& engine, networkDestinationCode destination)
+		{
+			if (elapsed(heartbeatSnapshot) < heartbeatInterval)
+				return 0;
+
+			heartbeatSnapshot = high_resolution_clock::now();
+
+			// Local variable(s):
+			bool hasHeartbeat = false;
+
+			for (gamepadID i = 0; i < gamepads.capacity(); i++)
+			{
+				if (gamepads.connected(i) && gamepads.detects(i))
+				{
+					serializeGamepadHeartbeat(engine, engine, i, gamepads.remoteIdentifier(i));
+
+					hasHeartbeat = true;
+				}
+			}
+
+			if (!hasHeartbeat)
+				return 0;
+
+			// Heartbeats are batched, and sent unreliably; the next one replaces a lost one.
+			return engine.sendMessage(engine, destination);
+		}
+
+		void connectedDevices::checkGamepadSilence()
+		{
+			for (gamepadID i = 0; i < gamepads.capacity(); i++)
+			{
+				// We only expect to hear from gamepads detected remotely:
+				if (!gamepads.connected(i) || !gamepads.simulates(i) || gamepads.detects(i))
+					continue;
+
+				auto pad = gamepads[i];
+
+				if (pad->silenceReported)
+					continue;
+
+				if (pad->silence() >= gamepadTimeout)
+				{
+					deviceInfo << "Gamepad #" << (int)pad->localGamepadNumber << " hasn't been heard from in " << pad->silence().count() << "ms." << endl;
+
+					pad->silenceReported = true;
+				}
+			}
+
+			return;
+		}
+
 		size_t connectedDevices::sendTo(iosync_application* program, networkEngine& engine)
 		{
 			if (program->multiWayOperations()) // engine.canBroadcastLocally()
@@ -1245,21 +1527,48 @@ namespace iosync
 			return sendTo(engine, DEFAULT_DESTINATION);
 		}
 
-		size_t connectedDevices::reliableSendTo(iosync_application* program, networkEngine& engine)
+		size_t connectedDevices::reliableSendTo(iosync_application* program, networkEngine& engine, bool sampling)
 		{
 			if (program->multiWayOperations()) // engine.canBroadcastLocally()
 			{
 				if (program->network->isHostNode)
 				{
-					return reliableSendTo(engine, DESTINATION_ALL);
+					return reliableSendTo(engine, DESTINATION_ALL, sampling);
 				}
 				else
 				{
-					return reliableSendTo(engine, DESTINATION_EVERYONE); // DESTINATION_ALL
+					return reliableSendTo(engine, DESTINATION_EVERYONE, sampling); // DESTINATION_ALL
+				}
+			}
+
+			return reliableSendTo(engine, DEFAULT_DESTINATION, sampling);
+		}
+
+		void connectedDevices::onPacketConfirmed(packetID ID)
+		{
+			for (gamepadID i = 0; i < gamepads.capacity(); i++)
+			{
+				if (gamepads.connected(i) && gamepads[i]->onPacketConfirmed(ID))
+				{
+					// Packets only carry a single gamepad's state.
+					break;
+				}
+			}
+
+			return;
+		}
+
+		void connectedDevices::resetGamepadBaselines()
+		{
+			for (gamepadID i = 0; i < gamepads.capacity(); i++)
+			{
+				if (gamepads.connected(i))
+				{
+					gamepads[i]->resetBaseline();
 				}
 			}
 
-			return reliableSendTo(engine, DEFAULT_DESTINATION);
+			return;
 		}
 	}
 
@@ -1327,10 +1636,34 @@ namespace iosync
 		const wstring iosync_application::applicationConfiguration::DEVICES_VJOY_OFFSET = L"vjoy_offset";
 	#endif
 
+	const wstring iosync_application::applicationConfiguration::DEVICES_THUMB_DEADZONE = L"stick_deadzone";
+	const wstring iosync_application::applicationConfiguration::DEVICES_THUMB_HYSTERESIS = L"stick_hysteresis";
+	const wstring iosync_application::applicationConfiguration::DEVICES_THUMB_PRECISION = L"stick_precision";
+
+	const wstring iosync_application::applicationConfiguration::DEVICES_TRIGGER_DEADZONE = L"trigger_deadzone";
+	const wstring iosync_application::applicationConfiguration::DEVICES_TRIGGER_HYSTERESIS = L"trigger_hysteresis";
+	const wstring iosync_application::applicationConfiguration::DEVICES_TRIGGER_PRECISION = L"trigger_precision";
+
+	const wstring iosync_application::applicationConfiguration::DEVICES_MAX_INPUT_LATENCY = L"max_input_latency";
+
+	const wstring iosync_application::applicationConfiguration::DEVICES_INTERPOLATION = L"interpolate_input";
+	const wstring iosync_application::applicationConfiguration::DEVICES_MAX_EXTRAPOLATION = L"max_extrapolation";
+	const wstring iosync_application::applicationConfiguration::DEVICES_EXTRAPOLATION_ERROR = L"extrapolation_error";
+
+	const wstring iosync_application::applicationConfiguration::DEVICES_GAMEPAD_SAMPLE_RATE = L"gamepad_sample_rate";
+	const wstring iosync_application::applicationConfiguration::DEVICES_GAMEPAD_SEND_RATE = L"gamepad_send_rate";
+	const wstring iosync_application::applicationConfiguration::DEVICES_KEYBOARD_SEND_RATE = L"keyboard_send_rate";
+
 	// Networking:
 	const wstring iosync_application::applicationConfiguration::NETWORK_ADDRESS = L"address";
 	const wstring iosync_application::applicationConfiguration::NETWORK_PORT = L"port";
 	const wstring iosync_application::applicationConfiguration::NETWORK_USERNAME = L"username";
+	const wstring iosync_application::applicationConfiguration::NETWORK_PARENT = L"parent";
+	const wstring iosync_application::applicationConfiguration::NETWORK_MAX_DIRECT_PLAYERS = L"max_direct_players";
+	const wstring iosync_application::applicationConfiguration::NETWORK_MULTICAST = L"multicast";
+	const wstring iosync_application::applicationConfiguration::NETWORK_SUBSCRIBE = L"subscribe";
+	const wstring iosync_application::applicationConfiguration::NETWORK_AGGREGATE_FRAMES = L"aggregate_frames";
+	const wstring iosync_application::applicationConfiguration::NETWORK_RELAY_THREADS = L"relay_threads";
 
 	// Windows-specific:
 	#ifdef PLATFORM_WINDOWS
@@ -1552,8 +1885,8 @@ namespace iosync
 
 					try
 					{
-						// Read the maximum number of gamepads supported:
-						max_gamepads = stoi(max_gpds_str);
+						// Read the maximum number of gamepads supported; hubs may go beyond the native maximum, up to the size of a 'gamepadTable'.
+						max_gamepads = (unsigned char)min(max(stoi(max_gpds_str), 0), (int)devices::MAX_GAMEPAD_TABLE_SIZE);
 
 						/*
 						if (max_gamepads == 0)
@@ -1601,6 +1934,74 @@ namespace iosync
 							}
 						}
 					#endif
+
+					// Analog conditioning:
+					auto readConditioning = [&devices] (const wstring& property, unsigned short& output)
+					{
+						auto propertyIterator = devices.find(property);
+
+						if (propertyIterator != devices.end())
+						{
+							try
+							{
+								output = (unsigned short)stoi(propertyIterator->second);
+							}
+							catch (std::invalid_argument&)
+							{
+								// Keep the current setting.
+							}
+						}
+
+						return;
+					};
+
+					// Local variable(s):
+					unsigned short thumbPrecision = devices::DEFAULT_GAMEPAD_THUMB_PRECISION;
+					unsigned short triggerPrecision = devices::DEFAULT_GAMEPAD_TRIGGER_PRECISION;
+
+					devices::analogConditioning thumbs(devices::DEFAULT_GAMEPAD_THUMB_DEADZONE, devices::DEFAULT_GAMEPAD_THUMB_HYSTERESIS);
+					devices::analogConditioning triggers(devices::DEFAULT_GAMEPAD_TRIGGER_DEADZONE, devices::DEFAULT_GAMEPAD_TRIGGER_HYSTERESIS);
+
+					readConditioning(DEVICES_THUMB_DEADZONE, thumbs.deadzone);
+					readConditioning(DEVICES_THUMB_HYSTERESIS, thumbs.hysteresis);
+					readConditioning(DEVICES_THUMB_PRECISION, thumbPrecision);
+
+					readConditioning(DEVICES_TRIGGER_DEADZONE, triggers.deadzone);
+					readConditioning(DEVICES_TRIGGER_HYSTERESIS, triggers.hysteresis);
+					readConditioning(DEVICES_TRIGGER_PRECISION, triggerPrecision);
+
+					thumbs.precision = (unsigned char)min<unsigned short>(thumbPrecision, devices::GAMEPAD_THUMB_BITS);
+					triggers.precision = (unsigned char)min<unsigned short>(triggerPrecision, devices::GAMEPAD_TRIGGER_BITS);
+
+					gamepadInputConditioning.setThumbs(thumbs);
+					gamepadInputConditioning.setTriggers(triggers);
+
+					// Jitter buffering:
+					unsigned short maximumLatency = (unsigned short)gamepadMaximumLatency.count();
+
+					readConditioning(DEVICES_MAX_INPUT_LATENCY, maximumLatency);
+
+					gamepadMaximumLatency = (milliseconds)maximumLatency;
+
+					// Analog reconstruction:
+					auto interpolationIterator = devices.find(DEVICES_INTERPOLATION);
+
+					if (interpolationIterator != devices.end())
+					{
+						gamepadOutputReconstruction.interpolation = wstrEnabled(interpolationIterator->second);
+					}
+
+					unsigned short maximumExtrapolation = (unsigned short)gamepadOutputReconstruction.maximumExtrapolation.count();
+
+					readConditioning(DEVICES_MAX_EXTRAPOLATION, maximumExtrapolation);
+					readConditioning(DEVICES_EXTRAPOLATION_ERROR, gamepadOutputReconstruction.maximumError);
+
+					gamepadOutputReconstruction.maximumExtrapolation = (milliseconds)maximumExtrapolation;
+
+					// Sampling and send-rates:
+					readConditioning(DEVICES_GAMEPAD_SAMPLE_RATE, gamepadSampleRate);
+					readConditioning(DEVICES_GAMEPAD_SEND_RATE, gamepadSendRate);
+					readConditioning(DEVICES_KEYBOARD_SEND_RATE, keyboardSendRate);
 				}
 			}
 		}
@@ -1648,6 +2049,65 @@ namespace iosync
 				// Read the username specified.
 				username = usernameIterator->second;
 			}
+
+			auto parentIterator = networking.find(NETWORK_PARENT);
+
+			if (parentIterator != networking.end())
+			{
+				// Parse the address of the server we're relaying for.
+				parentAddress.parse(parentIterator->second, DEFAULT_PORT);
+			}
+
+			auto maxDirectIterator = networking.find(NETWORK_MAX_DIRECT_PLAYERS);
+
+			if (maxDirectIterator != networking.end())
+			{
+				try
+				{
+					maximumDirectPlayers = (size_t)stoul(maxDirectIterator->second);
+				}
+				catch (std::invalid_argument&)
+				{
+					maximumDirectPlayers = 0;
+				}
+			}
+
+			auto multicastIterator = networking.find(NETWORK_MULTICAST);
+
+			if (multicastIterator != networking.end())
+			{
+				// Parse the multicast group used for broadcasts.
+				multicastGroup.parse(multicastIterator->second, DEFAULT_PORT);
+			}
+
+			auto subscribeIterator = networking.find(NETWORK_SUBSCRIBE);
+
+			if (subscribeIterator != networking.end())
+			{
+				// Parse the devices we need states from.
+				subscriptions = deviceManagement::connectedDevices::parseSubscriptions(subscribeIterator->second);
+			}
+
+			auto aggregateIterator = networking.find(NETWORK_AGGREGATE_FRAMES);
+
+			if (aggregateIterator != networking.end())
+			{
+				aggregateFrames = wstrEnabled(aggregateIterator->second);
+			}
+
+			auto relayThreadsIterator = networking.find(NETWORK_RELAY_THREADS);
+
+			if (relayThreadsIterator != networking.end())
+			{
+				try
+				{
+					relayThreads = (size_t)stoul(relayThreadsIterator->second);
+				}
+				catch (std::invalid_argument&)
+				{
+					relayThreads = 0;
+				}
+			}
 		}
 		else
 		{
@@ -1728,6 +2188,30 @@ namespace iosync
 				devices[DEVICES_VJOY_OFFSET] = to_wstring(vJoy_DeviceOffset);
 		#endif
 
+		// Analog conditioning (Sticks share settings, as do triggers):
+		const auto& thumbs = gamepadInputConditioning.axes[devices::GAMEPAD_FIELD_THUMB_LX - devices::GAMEPAD_FIELD_ANALOG_FIRST];
+		const auto& triggers = gamepadInputConditioning.axes[devices::GAMEPAD_FIELD_LEFT_TRIGGER - devices::GAMEPAD_FIELD_ANALOG_FIRST];
+
+		devices[DEVICES_THUMB_DEADZONE] = to_wstring(thumbs.deadzone);
+		devices[DEVICES_THUMB_HYSTERESIS] = to_wstring(thumbs.hysteresis);
+		devices[DEVICES_THUMB_PRECISION] = to_wstring(thumbs.precision);
+
+		devices[DEVICES_TRIGGER_DEADZONE] = to_wstring(triggers.deadzone);
+		devices[DEVICES_TRIGGER_HYSTERESIS] = to_wstring(triggers.hysteresis);
+		devices[DEVICES_TRIGGER_PRECISION] = to_wstring(triggers.precision);
+
+		devices[DEVICES_MAX_INPUT_LATENCY] = to_wstring(gamepadMaximumLatency.count());
+
+		// Analog reconstruction:
+		devices[DEVICES_INTERPOLATION] = to_wstring(gamepadOutputReconstruction.interpolation);
+		devices[DEVICES_MAX_EXTRAPOLATION] = to_wstring(gamepadOutputReconstruction.maximumExtrapolation.count());
+		devices[DEVICES_EXTRAPOLATION_ERROR] = to_wstring(gamepadOutputReconstruction.maximumError);
+
+		// Sampling and send-rates:
+		devices[DEVICES_GAMEPAD_SAMPLE_RATE] = to_wstring(gamepadSampleRate);
+		devices[DEVICES_GAMEPAD_SEND_RATE] = to_wstring(gamepadSendRate);
+		devices[DEVICES_KEYBOARD_SEND_RATE] = to_wstring(keyboardSendRate);
+
 		// Networking:
 
 		auto& networking = variables[NETWORK_SECTION];
@@ -1747,6 +2231,24 @@ namespace iosync
 		if (!username.empty())
 			networking[NETWORK_USERNAME] = username;
 
+		if (parentAddress.isSet())
+			parentAddress.encodeTo(networking[NETWORK_PARENT]);
+
+		if (maximumDirectPlayers > 0)
+			networking[NETWORK_MAX_DIRECT_PLAYERS] = to_wstring(maximumDirectPlayers);
+
+		if (multicastGroup.isSet())
+			multicastGroup.encodeTo(networking[NETWORK_MULTICAST]);
+
+		if (subscriptions != SUBSCRIPTION_CHANNELS_ALL)
+			networking[NETWORK_SUBSCRIBE] = deviceManagement::connectedDevices::encodeSubscriptions(subscriptions);
+
+		if (aggregateFrames)
+			networking[NETWORK_AGGREGATE_FRAMES] = to_wstring(aggregateFrames);
+
+		if (relayThreads > 0)
+			networking[NETWORK_RELAY_THREADS] = to_wstring(relayThreads);
+
 		// Windows-specific:
 		#ifdef PLATFORM_WINDOWS
 			// XInput:
@@ -2104,12 +2606,38 @@ namespace iosync
 	}
 
 	// Methods:
-	int iosync_application::execute(const addressPort port, const applicationMode mode)
+	int iosync_application::execute(const addressPort port, const applicationMode mode, const representativeAddress& parentAddress, const wstring& username, size_t maximumDirectPlayers, const representativeAddress& multicastGroup, bool aggregateFrames, size_t relayThreads)
 	{
 		cout << "Attempting to open server network (" << port << ")..." << endl << endl;
 
 		// Allocate a new "networking engine".
-		auto engine = new serverNetworkEngine(*this);
+		serverNetworkEngine* engine = nullptr;
+
+		#ifdef NETWORK_RELAY_SHARDS
+			// Relays may spread their players across several threads:
+			if (mode == MODE_RELAY && relayThreads > 1 && !(multicastGroup.isSet() && address::addressSet(multicastGroup.IP)) && !(parentAddress.isSet() && address::addressSet(parentAddress.IP)))
+			{
+				cout << "Relaying with " << relayThreads << " threads." << endl << endl;
+
+				auto shards = new relayShardEngine(*this, relayThreads);
+
+				shards->maximumIdleDelay = (milliseconds)RELAY_MAXIMUM_IDLE_DELAY;
+
+				// The other shards start as soon as they're open, so they need to know we're only relaying.
+				this->mode = mode;
+
+				engine = shards;
+			}
+		#endif
+
+		if (engine == nullptr)
+		{
+			engine = new serverNetworkEngine(*this);
+		}
+
+		// These are applied before opening, so every shard uses them. (See 'relayShardEngine')
+		engine->maximumDirectPlayers = maximumDirectPlayers;
+		engine->aggregateFrames = aggregateFrames;
 
 		// Attempt to host using the port specified:
 		if (!engine->open(port))
@@ -2129,11 +2657,27 @@ namespace iosync
 
 		cout << "Server network started." << endl << endl;
 
+		// Deliver broadcasts to a multicast group, if one was specified:
+		if (multicastGroup.isSet() && address::addressSet(multicastGroup.IP))
+		{
+			cout << "Broadcasting to multicast group (" << multicastGroup.IP << networking::ADDRESS_SEPARATOR << multicastGroup.port << ")." << endl << endl;
+
+			engine->multicastGroup = address(multicastGroup.IP, multicastGroup.port);
+		}
+
+		// Check if we're relaying for another server:
+		if (parentAddress.isSet() && address::addressSet(parentAddress.IP))
+		{
+			cout << "Joining parent server as a relay node (" << parentAddress.IP << networking::ADDRESS_SEPARATOR << parentAddress.port << ")..." << endl << endl;
+
+			engine->joinParent(engine->socket, address(parentAddress.IP, parentAddress.port), (username.empty()) ? DEFAULT_PLAYER_NAME : username);
+		}
+
 		// Execute the creation call-back.
 		onCreate(mode);
 
-		// Call the super-class's implementation.
-		auto responseCode = application::execute();
+		// Relays use their own loop; otherwise, call the super-class's implementation.
+		auto responseCode = (relayOnly()) ? executeRelay() : application::execute();
 
 		// Execute the cleanup/close call-back.
 		onClose();
@@ -2386,13 +2930,16 @@ namespace iosync
 		return execute(DEFAULT_PORT);
 	}
 
-	int iosync_application::execute(const wstring& username, const string& remoteAddress, const addressPort remotePort, const addressPort localPort, const applicationMode mode)
+	int iosync_application::execute(const wstring& username, const string& remoteAddress, const addressPort remotePort, const addressPort localPort, const applicationMode mode, subscriptionChannels subscriptions)
 	{
 		cout << "Attempting to open client network (" << remoteAddress << networking::ADDRESS_SEPARATOR << remotePort << ")..." << endl << endl;
 
 		// Allocate a new "networking engine".
 		auto engine = new clientNetworkEngine(*this, username);
 
+		// Only ask the server for the devices we need. (Sent once we've joined)
+		engine->subscribe(engine->socket, subscriptions);
+
 		// Attempt to connect to the address specified.
 		if (!engine->open(remoteAddress, remotePort, localPort))
 		{
@@ -2444,6 +2991,44 @@ namespace iosync
 		}
 	#endif
 
+	int iosync_application::executeRelay()
+	{
+		// Local variable(s):
+		milliseconds idleDelay = (milliseconds)0;
+
+		currentFrame = 0;
+
+		// Set the execution-flag to 'true'.
+		isRunning = true;
+
+		while (isRunning && network != nullptr)
+		{
+			#ifdef IOSYNC_LIVE_COMMANDS
+				parseCommands();
+			#endif
+
+			updateNetwork();
+
+			currentFrame++;
+
+			// Keep forwarding without delay while messages are arriving:
+			if (network != nullptr && network->messagesHandled() > 0)
+			{
+				idleDelay = (milliseconds)0;
+
+				continue;
+			}
+
+			// The longer we're idle, the longer we wait to poll again. (No longer than a normal update)
+			idleDelay = min(max((idleDelay * 2), (milliseconds)1), (milliseconds)RELAY_MAXIMUM_IDLE_DELAY);
+
+			this_thread::sleep_for(idleDelay);
+		}
+
+		// Return the default response.
+		return 0;
+	}
+
 	int iosync_application::applyConfiguration(applicationConfiguration& configuration)
 	{
 		if (configuration.useCmd)
@@ -2482,14 +3067,27 @@ namespace iosync
 		// Apply device configurations:
 		devices.max_gamepads = configuration.max_gamepads;
 
+		// Virtual gamepads are only limited by the size of the table; the native slots are always available.
+		devices.gamepads.resize(max((size_t)devices.max_gamepads, (size_t)devices::MAX_GAMEPADS));
+
 		#ifdef IOSYNC_DEVICE_KEYBOARD
 			devices.keyboardEnabled = configuration.keyboardEnabled;
+			devices.keyboardSendRate = configuration.keyboardSendRate;
 		#else
 			devices.keyboardEnabled = false;
 		#endif
 
 		#ifdef IOSYNC_DEVICE_GAMEPAD
 			devices.gamepadsEnabled = configuration.gamepadsEnabled;
+			devices.gamepadInputConditioning = configuration.gamepadInputConditioning;
+			devices.gamepadMaximumLatency = configuration.gamepadMaximumLatency;
+			devices.gamepadOutputReconstruction = configuration.gamepadOutputReconstruction;
+
+			devices.gamepadSampleRate = configuration.gamepadSampleRate;
+			devices.gamepadSendRate = configuration.gamepadSendRate;
+
+			// Gamepads are sampled between updates, so the main loop needs to know how often.
+			sampleRate = devices.gamepadSampleRate;
 
 			#ifdef GAMEPAD_VJOY_ENABLED
 				devices.vJoyEnabled = configuration.vJoyEnabled;
@@ -2511,7 +3109,7 @@ namespace iosync
 					// Check if a proper address was specified:
 					if (address::addressSet(configuration.remoteAddress.IP))
 					{
-						return execute((configuration.username.empty()) ? DEFAULT_PLAYER_NAME : configuration.username, configuration.remoteAddress.IP, configuration.remoteAddress.port, 0, configuration.mode);
+						return execute((configuration.username.empty()) ? DEFAULT_PLAYER_NAME : configuration.username, configuration.remoteAddress.IP, configuration.remoteAddress.port, 0, configuration.mode, configuration.subscriptions);
 					}
 					else
 					{
@@ -2565,7 +3163,8 @@ namespace iosync
 				} while(true);
 			case MODE_DIRECT_SERVER:
 			case MODE_SERVER:
-				return execute(configuration.remoteAddress.port, configuration.mode);
+			case MODE_RELAY:
+				return execute(configuration.remoteAddress.port, configuration.mode, configuration.parentAddress, configuration.username, configuration.maximumDirectPlayers, configuration.multicastGroup, configuration.aggregateFrames, configuration.relayThreads);
 		}
 
 		cout << "Invalid application-mode specified." << endl;
@@ -2577,7 +3176,7 @@ namespace iosync
 	{
 		configuration.remoteAddress.port = DEFAULT_PORT;
 
-		cout << "Application mode (" << MODE_CLIENT << " = Client, " << MODE_SERVER << " = Server, " << MODE_DIRECT_CLIENT << " = Multi-way Client, " << MODE_DIRECT_SERVER << " = Multi-way Server): "; cin >> mode; //cout << endl;
+		cout << "Application mode (" << MODE_CLIENT << " = Client, " << MODE_SERVER << " = Server, " << MODE_DIRECT_CLIENT << " = Multi-way Client, " << MODE_DIRECT_SERVER << " = Multi-way Server, " << MODE_RELAY << " = Relay): "; cin >> mode; //cout << endl;
 
 		if (logChoices)
 		{
@@ -2623,9 +3222,10 @@ namespace iosync
 
 				//clearConsole();
 
-				return execute(configuration.username, configuration.remoteAddress.IP, configuration.remoteAddress.port, DEFAULT_LOCAL_PORT, mode);
+				return execute(configuration.username, configuration.remoteAddress.IP, configuration.remoteAddress.port, DEFAULT_LOCAL_PORT, mode, configuration.subscriptions);
 			case MODE_DIRECT_SERVER:
 			case MODE_SERVER:
+			case MODE_RELAY:
 				{
 					#ifndef IOSYNC_FAST_TESTMODE
 						configuration.remoteAddress.port = requestPort(cin); // cout << endl;
@@ -2698,7 +3298,7 @@ namespace iosync
 
 				//clearConsole();
 
-				return execute(configuration.remoteAddress.port, mode);
+				return execute(configuration.remoteAddress.port, mode, configuration.parentAddress, configuration.username, configuration.maximumDirectPlayers, configuration.multicastGroup, configuration.aggregateFrames, configuration.relayThreads);
 		}
 
 		// If all else fails, host with the default port.
@@ -2716,15 +3316,24 @@ namespace iosync
 		this->mode = mode;
 
 		#ifdef IOSYNC_SHAREDWINDOW_IMPLEMENTED
-			// Attempt to open the internal window.
-			this->window = sharedWindow::open(OSInfo);
+			// Relays don't handle device input, so they don't need a window.
+			if (relayOnly())
+			{
+				this->window = WINDOW_NONE;
+			}
+			else
+			{
+				// Attempt to open the internal window.
+				this->window = sharedWindow::open(OSInfo);
 
-			if (window == WINDOW_NONE)
-				throw noWindowException(this);
+				if (window == WINDOW_NONE)
+					throw noWindowException(this);
+			}
 		#endif
 
-		// Link with any dynamic modules we may need.
-		dynamicLink(*this);
+		// Link with any dynamic modules we may need. (Relays don't use devices)
+		if (!relayOnly())
+			dynamicLink(*this);
 
 		#ifdef IOSYNC_ALLOW_PROCESS_SYNCHRONIZATION
 			synchronizedApplicationRefreshTimer = high_resolution_clock::now();
@@ -2748,7 +3357,8 @@ namespace iosync
 		#endif
 
 		// Un-link any dynamic modules we're using.
-		dynamicUnlink(*this);
+		if (!relayOnly())
+			dynamicUnlink(*this);
 
 		#ifdef IOSYNC_SHAREDWINDOW_IMPLEMENTED
 			//sharedWindow::close();
@@ -2782,7 +3392,8 @@ namespace iosync
 			parseCommands();
 		#endif
 
-		updateDevices();
+		if (!relayOnly())
+			updateDevices();
 
 		if (network != nullptr)
 		{
@@ -2802,6 +3413,30 @@ namespace iosync
 		return;
 	}
 
+	void iosync_application::sample()
+	{
+		if (relayOnly())
+			return;
+
+		devices.sampleGamepads(this);
+
+		// Classes of device with their own send-rates may be due between updates; anything else waits for 'updateNetwork'.
+		if (network != nullptr && devices.hasDeviceConnected() && network->connectedToOthers())
+		{
+			switch (mode)
+			{
+				case MODE_DIRECT_SERVER:
+				case MODE_DIRECT_CLIENT:
+				case MODE_CLIENT:
+					devices.reliableSendTo(this, *network, true);
+
+					break;
+			}
+		}
+
+		return;
+	}
+
 	void iosync_application::updateNetwork()
 	{
 		if (devices.hasDeviceConnected() && network->connectedToOthers())
@@ -2865,34 +3500,15 @@ namespace iosync
 
 			//if (!network->isHostNode)
 			{
-				static const auto padbuffer = 20;
-
 				bool resumeApplications = true;
 
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < devices.gamepads.capacity(); i++)
 				{
 					if (devices.gamepadConnected(i))
 					{
-						if (devices.gamepads[i]->connected_real())
-						{
-							const bool empty = devices.gamepads[i]->stateLog.empty();
-
-							/*
-							while (devices.gamepads[i]->stateLog.size() < padbuffer)
-							{
-								if (!empty)
-								{
-									devices.gamepads[i]->stateLog.push_back(devices.gamepads[i]->stateLog.back());
-								}
-								else
-								{
-									devices.gamepads[i]->stateLog.push_back(gamepadState());
-								}
-							}
-							*/
-						}
-
-						if (!devices.gamepads[i]->hasStates() || devices.gamepads[i]->stateLog.size() < padbuffer) // 20 //  && (!network->isHostNode || !gamepad::realDeviceConnected(devices.gamepads[i]->localGamepadNumber) // devices.gamepads[i]->connected_real()
+						// Wait until this gamepad has buffered enough states to cover its measured jitter. (See 'gamepad::targetDepth')
+						// Brief underruns are covered by extrapolation instead. (See 'gamepad::extrapolateState')
+						if (!devices.gamepads[i]->bufferReady(*this) && !devices.gamepads[i]->canExtrapolate()) //  && (!network->isHostNode || !gamepad::realDeviceConnected(devices.gamepads[i]->localGamepadNumber) // devices.gamepads[i]->connected_real()
 						{
 							//cout << "Gamepad[" << i << "] (" << devices.gamepads[i]->localGamepadNumber << ", " << devices.gamepads[i]->remoteGamepadNumber << "): No states found, suspending." << endl;
 
@@ -2908,11 +3524,11 @@ namespace iosync
 
 				if (resumeApplications)
 				{
-					for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+					for (gamepadID i = 0; i < devices.gamepads.capacity(); i++)
 					{
 						if (devices.gamepadConnected(i))
 						{
-							if (devices.gamepads[i]->canSimulate())
+							if (devices.gamepads.simulates(i))
 							{
 								devices.gamepads[i]->simulate(*this);
 							}
@@ -3062,6 +3678,14 @@ namespace iosync
 		switch (header.type)
 		{
 			case MESSAGE_TYPE_DEVICE:
+				// Relays don't simulate devices; device messages are only forwarded.
+				if (relayOnly())
+				{
+					socket.inSeekForward(header.packetSize);
+
+					break;
+				}
+
 				// Route device packets to the 'devices' manager.
 				// In the event a device wasn't found, tell our caller:
 				if (devices.parseDeviceMessage(this, socket, header, footer) != deviceManagement::DEVICE_TYPE_NOT_FOUND)
@@ -3085,6 +3709,18 @@ namespace iosync
 		return true;
 	}
 
+	subscriptionChannels iosync_application::getNetworkMessageChannels(QSocket& socket, const messageHeader& header)
+	{
+		switch (header.type)
+		{
+			case MESSAGE_TYPE_DEVICE:
+				return devices.parseDeviceMessageChannels(socket);
+		}
+
+		// Return the default response.
+		return SUBSCRIPTION_CHANNELS_ALL;
+	}
+
 	// Call-backs:
 	void iosync_application::onNetworkConnected(networkEngine& engine)
 	{
@@ -3125,6 +3761,13 @@ namespace iosync
 
 		networkLog << "Player address: "; p.outputAddressInfo(networkLogStream, true);
 
+		// Relays have no devices. (These may also be called from other threads; see 'relayShardEngine')
+		if (relayOnly())
+			return;
+
+		// The new player doesn't have our gamepad baselines, so send keyframes.
+		devices.resetGamepadBaselines();
+
 		switch (mode)
 		{
 			case MODE_DIRECT_SERVER:
@@ -3142,6 +3785,10 @@ namespace iosync
 		wnetworkLog << "Player timed-out: " << p.name << endl;
 		networkLog << "Timed-out player's address: "; p.outputAddressInfo(networkLogStream, true);
 
+		// Relays have no devices.
+		if (relayOnly())
+			return;
+
 		devices.disconnectLocalGamepads(this, &p);
 
 		return;
@@ -3176,6 +3823,17 @@ namespace iosync
 		return;
 	}
 
+	void iosync_application::onNetworkPacketConfirmed(networkEngine&, packetID ID)
+	{
+		// Relays have no devices.
+		if (relayOnly())
+			return;
+
+		devices.onPacketConfirmed(ID);
+
+		return;
+	}
+
 	#ifdef IOSYNC_SHAREDWINDOW_IMPLEMENTED
 		nativeWindow iosync_application::getWindow() const
 		{
@@ -57,10 +57,12 @@
 
 #include "networking/networking.h"
 #include "networking/networkEngine.h"
+#include "networking/relayShards.h"
 
 #include "devices/devices.h"
 #include "devices/keyboard.h"
 #include "devices/gamepad.h"
+#include "devices/gamepadTable.h"
 
 // QuickLib:
 #include <QuickLib/QuickINI/QuickINI.h>
@@ -201,12 +203,19 @@ namespace iosync
 			DEVICE_NETWORK_MESSAGE_CONNECT,
 			DEVICE_NETWORK_MESSAGE_DISCONNECT,
 			DEVICE_NETWORK_MESSAGE_ENTRIES,
+
+			// A low-rate summary of a device's state; used to detect silence and lost states.
+			DEVICE_NETWORK_MESSAGE_HEARTBEAT,
+
 			DEVICE_NETWORK_MESSAGE_INVALID,
 		};
 
 		enum gamepadMetrics : unsigned long long
 		{
 			GAMEPAD_DEFAULT_TIMEOUT = 15000,
+
+			// The rate heartbeats are sent at while device-states aren't changing.
+			GAMEPAD_DEFAULT_HEARTBEAT_INTERVAL = 1000,
 		};
 
 		// Structures:
@@ -231,6 +240,24 @@ namespace iosync
 			bool keyboardEnabled;
 			bool gamepadsEnabled;
 
+			// Applied to every locally detected gamepad.
+			gamepadConditioning gamepadInputConditioning;
+
+			// The most latency buffering may add to each simulated gamepad.
+			milliseconds gamepadMaximumLatency = (milliseconds)DEFAULT_GAMEPAD_MAXIMUM_LATENCY;
+
+			// Applied to every simulated gamepad; smooths the analog inputs between, and past the states received.
+			gamepadReconstruction gamepadOutputReconstruction;
+
+			// Rates (In hertz):
+
+			// The rate locally detected gamepads are sampled at, between updates. (Zero only samples once per update)
+			rate gamepadSampleRate = 0;
+
+			// The most often each class of device sends its state. (Zero sends with every update)
+			rate gamepadSendRate = 0;
+			rate keyboardSendRate = 0;
+
 			#ifdef GAMEPAD_VJOY_ENABLED
 				UINT vJoy_DeviceOffset;
 				
@@ -244,15 +271,24 @@ namespace iosync
 
 			// Devices:
 			kbd* keyboard;
-			gp* gamepads[MAX_GAMEPADS];
 
-			// A set of reserved gamepad device-identifiers. This is used
-			// to ensure clients don't repeatedly request to connect a gamepad.
-			unordered_set<gamepadID> reservedGamepads;
+			// Every 'gamepad' object, indexed by local identifier. This is sized using 'max_gamepads'.
+			// Reserved identifiers are tracked here as well; this ensures clients don't repeatedly request to connect a gamepad.
+			gamepadTable gamepads;
 
 			// The "timeout" for gamepads.
 			milliseconds gamepadTimeout;
 
+			// The amount of time between gamepad heartbeats.
+			milliseconds heartbeatInterval;
+
+			// A "snapshot" of the last time we sent heartbeats.
+			high_resolution_clock::time_point heartbeatSnapshot;
+
+			// "Snapshots" of the last time each class of device sent its state. (See 'sendDue')
+			high_resolution_clock::time_point gamepadSendSnapshot;
+			high_resolution_clock::time_point keyboardSendSnapshot;
+
 			// Constructor(s):
 			connectedDevices
 			(
@@ -272,13 +308,13 @@ namespace iosync
 
 			inline void destroyGamepads()
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					destroyGamepad(i);
 				}
 
-				// Clear the reserved-gamepad container.
-				reservedGamepads.clear();
+				// Clear any reserved identifiers.
+				gamepads.clearReservations();
 
 				return;
 			}
@@ -294,6 +330,9 @@ namespace iosync
 			// This will update every 'gamepad' that's connected.
 			void updateGamepads(iosync_application* program);
 
+			// This reads the state of every locally detected gamepad, without simulating anything. (Called between updates)
+			void sampleGamepads(iosync_application* program);
+
 			// This command will connect every device.
 			void connect(iosync_application* program);
 
@@ -360,15 +399,13 @@ namespace iosync
 			{
 				bool response = false;
 
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
-					if (gamepads[i] != nullptr && gamepads[i]->owner == owner)
+					if (gamepads[i] != nullptr && gamepads.owner(i) == owner)
 					{
 						if (disconnectGamepad(program, gamepads[i]->localGamepadNumber))
 						{
 							response = true;
-
-							gamepads[i] = nullptr;
 						}
 					}
 				}
@@ -387,7 +424,7 @@ namespace iosync
 				// Local variable(s):
 				bool response = true;
 
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					if (!disconnectGamepad(program, identifier))
 					{
@@ -416,10 +453,10 @@ namespace iosync
 			// This command will manually connect every 'gamepad' possible.
 			// Clients should only ever use this for testing purposes.
 			// Servers may call this at their own leisure.
-			// This will return a pointer to the internal 'gamepads' array.
-			inline gamepad** connectGamepads(iosync_application* program)
+			// This will return a reference to the internal 'gamepads' table.
+			inline gamepadTable& connectGamepads(iosync_application* program)
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					connectGamepad(program, i, i);
 				}
@@ -427,40 +464,23 @@ namespace iosync
 				return gamepads;
 			}
 
-			inline gamepadID getNextGamepadID(bool checkRealDevices) const
+			// This retrieves the lowest free local identifier. ('GAMEPAD_ID_NONE' if the table is full)
+			inline gamepadID getNextGamepadID(bool checkRealDevices)
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
-				{
-					if
-					(
-						(gamepads[i] == nullptr)
-
-						#ifdef PLATFORM_WINDOWS
-							// If requested, ensure a real device isn't plugged in.
-							&& (!checkRealDevices || (!gp::__winnt__pluggedIn(i)))
-						#endif
-					)
-					{
-						return i;
-					}
-				}
+				#ifdef PLATFORM_WINDOWS
+					// If requested, ensure a real device isn't plugged in.
+					if (checkRealDevices)
+						return gamepads.nextFree([](gamepadID i) { return !gp::__winnt__pluggedIn(i); });
+				#endif
 
-				return GAMEPAD_ID_NONE;
+				return gamepads.nextFree();
 			}
 
 			// This will map a remote gamepad-identifier to a local 'gamepad' object.
 			// If a device could not be found, this will return 'nullptr'.
 			inline gamepad* getGamepad(gamepadID identifier) const
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
-				{
-					if (gamepadConnected(i) && gamepads[i]->remoteGamepadNumber == identifier)
-					{
-						return gamepads[i];
-					}
-				}
-
-				return nullptr;
+				return gamepads[gamepads.findRemote(identifier)];
 			}
 
 			// This will retrieve a gamepad using its local identifier.
@@ -469,7 +489,7 @@ namespace iosync
 			// If a device couldn't be found, this will return 'nullptr'.
 			inline gamepad* getLocalGamepad(gamepadID identifier)
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					if (gamepadConnected(i) && gamepads[i]->localGamepadNumber == identifier)
 					{
@@ -482,7 +502,7 @@ namespace iosync
 
 			inline bool hasGamepadConnected()
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					if (gamepadConnected(i))
 						return true;
@@ -496,7 +516,7 @@ namespace iosync
 			{
 				size_t count = 0;
 
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					if (gamepadConnected(i))
 						count += 1;
@@ -516,6 +536,24 @@ namespace iosync
 			// using the 'socket' object for extension-specific data. Extensions may not be applied if 'extended' is set to 'false'.
 			bool disconnectDeviceThroughNetwork(iosync_application* program, QSocket& socket, deviceType devType, bool extended);
 
+			// Subscription related:
+
+			// Only device-states are routed; connection messages are sent to everyone.
+			static inline bool isStateMessage(deviceMessageType devMsgType)
+			{
+				return (devMsgType == DEVICE_NETWORK_MESSAGE_ENTRIES || devMsgType == DEVICE_NETWORK_MESSAGE_HEARTBEAT);
+			}
+
+			// This retrieves the routing channel of a device. (See 'networkEngine::routeMessage')
+			static subscriptionChannels deviceChannel(deviceType devType, gamepadID identifier=GAMEPAD_ID_NONE);
+
+			// This parses a list of devices (Such as "keyboard, 0, 2"; gamepads are listed by identifier), then produces their channels.
+			static subscriptionChannels parseSubscriptions(const wstring& devicesList);
+			static wstring encodeSubscriptions(subscriptionChannels channels);
+
+			// This retrieves the channels of a device-message. The input should be at the beginning of the message's data-segment.
+			subscriptionChannels parseDeviceMessageChannels(QSocket& socket);
+
 			// Unless you want to manually write a sub-message type, please use the other overload.
 			// This acts as a macro for 'beginMessage', which specifies the targeted device.
 			// There is no 'finishDeviceMessage', as it is not needed.
@@ -532,6 +570,12 @@ namespace iosync
 				// Write the sub-message type specified.
 				socket.write<deviceMessageType>(devMsgType);
 
+				// Device-states are only routed to players subscribed to the device. (Gamepads are routed by identifier)
+				if (devType != DEVICE_TYPE_GAMEPAD && isStateMessage(devMsgType))
+				{
+					engine.routeMessage(deviceChannel(devType));
+				}
+
 				// Return the header-information.
 				return info;
 			}
@@ -551,6 +595,11 @@ namespace iosync
 				// Write the gamepad identifier specified.
 				socket.write<serializedGamepadID>((serializedGamepadID)identifier);
 
+				if (isStateMessage(devMsgType))
+				{
+					engine.routeMessage(deviceChannel(DEVICE_TYPE_GAMEPAD, identifier));
+				}
+
 				// Return the header-information.
 				return info;
 			}
@@ -559,14 +608,15 @@ namespace iosync
 			void serializeTo(networkEngine& engine, QSocket& socket);
 			void serializeKeyboard(networkEngine& engine, QSocket& socket);
 			void serializeGamepad(networkEngine& engine, QSocket& socket, gamepadID gamepadLocation, gamepadID remoteIdentifier);
+			void serializeGamepadHeartbeat(networkEngine& engine, QSocket& socket, gamepadID gamepadLocation, gamepadID remoteIdentifier);
 
 			inline void serializeGamepads(networkEngine& engine, QSocket& socket)
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
-					if (gamepadConnected(i) && gamepads[i]->canDetect() && gamepads[i]->hasRealState()) // gamepads[i]->canSimulate() || hasState()
+					if (gamepads.connected(i) && gamepads.detects(i) && gamepads[i]->hasRealState()) // gamepads[i]->canSimulate() || hasState()
 					{
-						serializeGamepad(engine, socket, i, gamepads[i]->remoteGamepadNumber);
+						serializeGamepad(engine, socket, i, gamepads.remoteIdentifier(i));
 					}
 				}
 
@@ -687,11 +737,33 @@ namespace iosync
 
 			// This will send the active serializable data this manager produces.
 			// Please call 'sendConnectionRequests' (Or similar) before calling this.
+			// When 'sampling' is set, this was called between updates; only classes of device with a send-rate are sent.
 			size_t sendTo(networkEngine& engine, networkDestinationCode destination);
-			size_t reliableSendTo(networkEngine& engine, networkDestinationCode destination);
+			size_t reliableSendTo(networkEngine& engine, networkDestinationCode destination, bool sampling=false);
 
 			size_t sendTo(iosync_application* program, networkEngine& engine);
-			size_t reliableSendTo(iosync_application* program, networkEngine& engine);
+			size_t reliableSendTo(iosync_application* program, networkEngine& engine, bool sampling=false);
+
+			// This specifies if a class of device sending at 'sendRate' may send now; if so, 'snapshot' is updated.
+			// Rates of zero send with every update, and never between them.
+			static bool sendDue(rate sendRate, high_resolution_clock::time_point& snapshot, bool sampling);
+
+			// This sends an unreliable heartbeat for every detected gamepad, if 'heartbeatInterval' has elapsed.
+			// Device-states are only sent when they change, so these let receivers detect silence and lost states.
+			size_t sendHeartbeats(networkEngine& engine, networkDestinationCode destination);
+
+			// This reports remote gamepads that haven't been heard from within 'gamepadTimeout'.
+			void checkGamepadSilence();
+
+			// Delta-encoding related:
+
+			// This is called once every recipient has confirmed the reliable packet specified.
+			// Gamepads use this to advance the baseline their states are encoded against.
+			void onPacketConfirmed(packetID ID);
+
+			// This forces every gamepad to send its next state as a keyframe.
+			// This is used when a new connection doesn't have our baselines.
+			void resetGamepadBaselines();
 
 			inline bool keyboardConnected() const
 			{
@@ -700,16 +772,16 @@ namespace iosync
 
 			// This will tell you if the local gamepad at the "location" specified is connected.
 			// To check if a gamepad is connected using a remote-identifier, please use 'remoteGamepadConnected'.
-			// This is primarily useful for routines which iterate through the 'gamepads' array.
+			// This is primarily useful for routines which iterate through the 'gamepads' table.
 			inline bool gamepadConnected(const gamepadID gamepadLocation) const
 			{
-				return ((gamepads[gamepadLocation] != nullptr) && gamepads[gamepadLocation]->connected());
+				return gamepads.connected(gamepadLocation);
 			}
 
 			// This will tell you if a connected gamepad has the local-identifier specified.
 			inline bool localGamepadConnected(const gamepadID identifier) const
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					if (gamepadConnected(i) && gamepads[i]->localGamepadNumber == identifier)
 					{
@@ -724,38 +796,26 @@ namespace iosync
 			// This will tell you if a connected gamepad has the remote-identifier specified.
 			inline bool remoteGamepadConnected(const gamepadID identifier) const
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
-				{
-					if (gamepadConnected(i))
-					{
-						if (gamepads[i]->remoteGamepadNumber == identifier)
-						{
-							return true;
-						}
-					}
-				}
-
-				// Return the default response.
-				return false;
+				return (gamepads.findRemote(identifier) != GAMEPAD_ID_NONE);
 			}
 
 			// This will determine if a local gamepad identifier is reserved, or otherwise taken.
 			inline bool gamepadReserved(const gamepadID identifier) const
 			{
-				// Check if the 'reservedGamepads' container has this identifier:
-				if (reservedGamepads.find(identifier) != reservedGamepads.end())
+				// Check if the 'gamepads' table has this identifier reserved:
+				if (gamepads.reserved(identifier))
 				{
 					// This is explicitly reserved; we can not use it.
 					return true;
 				}
 
-				gamepadID lowestRemoteID = MAX_GAMEPADS;
+				gamepadID lowestRemoteID = (gamepadID)gamepads.capacity();
 
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
-					if (gamepadConnected(i) && gamepads[i]->remoteGamepadNumber < lowestRemoteID)
+					if (gamepads.connected(i) && gamepads.remoteIdentifier(i) < lowestRemoteID)
 					{
-						lowestRemoteID = gamepads[i]->remoteGamepadNumber;
+						lowestRemoteID = gamepads.remoteIdentifier(i);
 					}
 				}
 
@@ -766,7 +826,7 @@ namespace iosync
 			inline bool gamepadConnected() const
 			{
 				// Check if at least one gamepad is connected:
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
 					if (gamepadConnected(i))
 						return true;
@@ -783,11 +843,11 @@ namespace iosync
 
 			inline bool playerHasDevice(player* p) const
 			{
-				for (gamepadID i = 0; i < MAX_GAMEPADS; i++)
+				for (gamepadID i = 0; i < gamepads.capacity(); i++)
 				{
-					if (gamepadConnected(i))
+					if (gamepads.connected(i))
 					{
-						if (gamepads[i]->owner == p)
+						if (gamepads.owner(i) == p)
 						{
 							return true;
 						}
@@ -820,6 +880,15 @@ namespace iosync
 
 				MODE_DIRECT_CLIENT = 2,
 				MODE_DIRECT_SERVER = 3,
+
+				// A headless server which only forwards messages between players. (See 'executeRelay')
+				MODE_RELAY = 4,
+			};
+
+			enum relayDelays : unsigned int
+			{
+				// The longest a relay waits between polls, in milliseconds. Waits double from one millisecond while idle.
+				RELAY_MAXIMUM_IDLE_DELAY = (1000 / DEFAULT_UPDATERATE),
 			};
 
 			enum messageTypes : messageType
@@ -889,6 +958,28 @@ namespace iosync
 					static const wstring DEVICES_VJOY_OFFSET;
 				#endif
 
+				// Analog conditioning; deadzones and hysteresis are in raw units, precision is in bits:
+				static const wstring DEVICES_THUMB_DEADZONE;
+				static const wstring DEVICES_THUMB_HYSTERESIS;
+				static const wstring DEVICES_THUMB_PRECISION;
+
+				static const wstring DEVICES_TRIGGER_DEADZONE;
+				static const wstring DEVICES_TRIGGER_HYSTERESIS;
+				static const wstring DEVICES_TRIGGER_PRECISION;
+
+				// The most latency gamepad jitter buffering may add, in milliseconds. (See 'gamepad::targetDepth')
+				static const wstring DEVICES_MAX_INPUT_LATENCY;
+
+				// Analog reconstruction; extrapolation is limited to a number of milliseconds, and an error in raw stick units:
+				static const wstring DEVICES_INTERPOLATION;
+				static const wstring DEVICES_MAX_EXTRAPOLATION;
+				static const wstring DEVICES_EXTRAPOLATION_ERROR;
+
+				// Sampling and send-rates, in hertz; zero uses the update-rate:
+				static const wstring DEVICES_GAMEPAD_SAMPLE_RATE;
+				static const wstring DEVICES_GAMEPAD_SEND_RATE;
+				static const wstring DEVICES_KEYBOARD_SEND_RATE;
+
 				// Networking:
 
 				// This is represented with an IP address / hostname, and optionally, a port.
@@ -901,6 +992,24 @@ namespace iosync
 
 				static const wstring NETWORK_USERNAME;
 
+				// When hosting, this may be used to relay for another server, as a "node". (Represented like 'NETWORK_ADDRESS')
+				static const wstring NETWORK_PARENT;
+
+				// When hosting, players past this limit are redirected to our "nodes". (Zero disables this)
+				static const wstring NETWORK_MAX_DIRECT_PLAYERS;
+
+				// When hosting, broadcasts are sent once to this multicast group, for players that receive it. (Local networks only)
+				static const wstring NETWORK_MULTICAST;
+
+				// When connecting, this lists the devices we need states from. (See 'connectedDevices::parseSubscriptions')
+				static const wstring NETWORK_SUBSCRIBE;
+
+				// When hosting, this aggregates relayed input into one "frame" per update. (See 'serverNetworkEngine::aggregateFrames')
+				static const wstring NETWORK_AGGREGATE_FRAMES;
+
+				// When relaying, this spreads players across several threads. (See 'relayShardEngine'; Zero and one disable this)
+				static const wstring NETWORK_RELAY_THREADS;
+
 				// Windows-specific
 				#ifdef PLATFORM_WINDOWS
 					// XInput:
@@ -941,8 +1050,24 @@ namespace iosync
 				// Fields:
 				representativeAddress remoteAddress;
 
+				// The server this application relays for, when hosting as a "node".
+				representativeAddress parentAddress;
+
 				wstring username;
 
+				size_t maximumDirectPlayers = 0;
+
+				// The multicast group used to deliver broadcasts, when hosting.
+				representativeAddress multicastGroup;
+
+				// The routing channels of the devices we need states from, when connecting.
+				subscriptionChannels subscriptions = SUBSCRIPTION_CHANNELS_ALL;
+
+				bool aggregateFrames = false;
+
+				// The number of threads used to relay, when relaying.
+				size_t relayThreads = 0;
+
 				applicationMode mode;
 
 				#ifdef PLATFORM_WINDOWS
@@ -1117,13 +1242,22 @@ namespace iosync
 
 			// Methods:
 			int execute();
-			int execute(const addressPort port, const applicationMode mode=MODE_SERVER);
-			int execute(const wstring& username, const string& remoteAddress, const addressPort remotePort = DEFAULT_PORT, const addressPort localPort = DEFAULT_LOCAL_PORT, const applicationMode mode=MODE_CLIENT);
+			int execute(const addressPort port, const applicationMode mode=MODE_SERVER, const representativeAddress& parentAddress=representativeAddress(), const wstring& username=wstring(), size_t maximumDirectPlayers=0, const representativeAddress& multicastGroup=representativeAddress(), bool aggregateFrames=false, size_t relayThreads=0);
+			int execute(const wstring& username, const string& remoteAddress, const addressPort remotePort = DEFAULT_PORT, const addressPort localPort = DEFAULT_LOCAL_PORT, const applicationMode mode=MODE_CLIENT, subscriptionChannels subscriptions=SUBSCRIPTION_CHANNELS_ALL);
 
 			#ifdef IOSYNC_ALLOW_ASYNC_EXECUTE
 				void executeAsync();
 			#endif
 
+			/*
+				This acts as the main loop of relay-only servers, in place of 'application::execute'.
+
+				Devices are never polled; the network is updated back to back while
+				messages arrive, then polled less often the longer it stays idle.
+			*/
+
+			int executeRelay();
+
 			// This command may be used in order to execute/start an application using a configuration-object.
 			int applyConfiguration(applicationConfiguration& configuration);
 
@@ -1140,6 +1274,9 @@ namespace iosync
 			void closeNetwork();
 
 			void update(rate frameNumber=0) override;
+
+			// Locally detected gamepads are sampled (And sent, if due) here, between updates.
+			void sample() override;
 			
 			void updateNetwork();
 			void updateDevices();
@@ -1175,6 +1312,8 @@ namespace iosync
 			// Parsing/deserialization related:
 			bool parseNetworkMessage(QSocket& socket, const messageHeader& header, const messageFooter& footer) override;
 
+			subscriptionChannels getNetworkMessageChannels(QSocket& socket, const messageHeader& header) override;
+
 			// Sending related:
 			// Nothing so far.
 
@@ -1183,6 +1322,7 @@ namespace iosync
 			void onNetworkClientConnected(networkEngine& engine, player& p) override;
 			void onNetworkClientTimedOut(networkEngine& engine, player& p) override;
 			void onNetworkClosed(networkEngine& engine) override;
+			void onNetworkPacketConfirmed(networkEngine& engine, packetID ID) override;
 
 			#ifdef IOSYNC_SHAREDWINDOW_IMPLEMENTED
 				nativeWindow getWindow() const override;
@@ -1230,6 +1370,11 @@ namespace iosync
 				return (multiWayClient() || multiWayHost());
 			}
 
+			inline bool relayOnly() const
+			{
+				return (mode == MODE_RELAY);
+			}
+
 			inline bool allowDeviceDetection() const
 			{
 				return (mode == MODE_CLIENT || multiWayOperations());
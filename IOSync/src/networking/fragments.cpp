@@ -0,0 +1,203 @@
+// Includes:
+#include "fragments.h"
+
+// Standard library:
+#include <cstring>
+
+// Namespace(s):
+namespace iosync
+{
+	namespace networking
+	{
+		// Structures:
+
+		// fragmentMetrics:
+
+		// Constructor(s):
+		fragmentMetrics::fragmentMetrics(size_t maxDatagramSize, size_t maxReassemblySize, size_t maxReassemblyMemory, size_t maxGroupsPerConnection, milliseconds timeout)
+			: maximumDatagramSize(maxDatagramSize), maximumReassemblySize(maxReassemblySize), maximumReassemblyMemory(maxReassemblyMemory), maximumGroupsPerConnection(maxGroupsPerConnection), reassemblyTimeout(timeout) { /* Nothing so far. */ }
+
+		// fragmentGroup:
+
+		// Constructor(s):
+		fragmentGroup::fragmentGroup(const address& origin, fragmentGroupID identifier, fragmentIndex count, fragmentLength totalSize)
+			: origin(origin), data(totalSize), receivedFragments(count, false), snapshot(high_resolution_clock::now()), totalSize(totalSize), identifier(identifier), count(count), received(0) { /* Nothing so far. */ }
+
+		// Classes:
+
+		// fragmentManager:
+
+		// Functions:
+		bool fragmentManager::loadDatagram(QSocket& socket, const fragmentedDatagram& datagram)
+		{
+			// Make sure the datagram fits in the socket's input-buffer:
+			if (datagram.data.empty() || datagram.data.size() > socket._bufferlength)
+				return false;
+
+			// Copy the reassembled datagram into the input-buffer.
+			memcpy(socket.inbuffer, datagram.data.data(), datagram.data.size());
+
+			socket.inbufferlen = datagram.data.size();
+
+			// Seek back to the beginning of the input.
+			socket.resetRead();
+
+			// Return the default response.
+			return true;
+		}
+
+		// Constructor(s):
+		fragmentManager::fragmentManager(const fragmentMetrics metrics)
+			: metrics(metrics), reassemblyMemory(0), nextGroupID(0) { /* Nothing so far. */ }
+
+		// Methods:
+		void fragmentManager::update()
+		{
+			auto group = groups.begin();
+
+			while (group != groups.end())
+			{
+				if (group->time() >= metrics.reassemblyTimeout)
+				{
+					removeGroup(group++);
+
+					continue;
+				}
+
+				group++;
+			}
+
+			return;
+		}
+
+		void fragmentManager::clear()
+		{
+			groups.clear();
+			completed.clear();
+
+			reassemblyMemory = 0;
+
+			return;
+		}
+
+		bool fragmentManager::addFragment(const address& origin, fragmentGroupID identifier, fragmentIndex index, fragmentIndex count, fragmentLength totalSize, fragmentLength offset, const uqchar* data, size_t dataSize)
+		{
+			// Check for errors:
+			if (index >= count || totalSize == 0 || totalSize > metrics.maximumReassemblySize)
+				return false;
+
+			if (((size_t)offset + dataSize) > totalSize)
+				return false;
+
+			auto group = getGroup(origin, identifier);
+
+			if (group == groups.end())
+			{
+				// Make sure this connection isn't holding onto too many datagrams:
+				if (groupsFrom(origin) >= metrics.maximumGroupsPerConnection)
+					return false;
+
+				// Discard the oldest datagrams until this one fits in memory:
+				while (!groups.empty() && (reassemblyMemory + totalSize) > metrics.maximumReassemblyMemory)
+				{
+					removeGroup(groups.begin());
+				}
+
+				if ((reassemblyMemory + totalSize) > metrics.maximumReassemblyMemory)
+					return false;
+
+				groups.push_back(fragmentGroup(origin, identifier, count, totalSize));
+
+				reassemblyMemory += totalSize;
+
+				group = --groups.end();
+			}
+			else if (group->count != count || group->totalSize != totalSize)
+			{
+				// This fragment doesn't describe the same datagram.
+				return false;
+			}
+
+			// Check if we've already received this fragment:
+			if (group->receivedFragments[index])
+				return true;
+
+			memcpy(group->data.data() + offset, data, dataSize);
+
+			group->receivedFragments[index] = true;
+			group->received++;
+
+			if (group->complete())
+			{
+				fragmentedDatagram datagram;
+
+				datagram.origin = group->origin;
+				datagram.data.swap(group->data);
+
+				completed.push_back(move(datagram));
+
+				removeGroup(group);
+			}
+
+			// Return the default response.
+			return true;
+		}
+
+		void fragmentManager::removeConnection(const address& origin)
+		{
+			auto group = groups.begin();
+
+			while (group != groups.end())
+			{
+				if (group->origin == origin)
+				{
+					removeGroup(group++);
+
+					continue;
+				}
+
+				group++;
+			}
+
+			return;
+		}
+
+		// Methods (Protected):
+		list<fragmentGroup>::iterator fragmentManager::getGroup(const address& origin, fragmentGroupID identifier)
+		{
+			for (auto group = groups.begin(); group != groups.end(); group++)
+			{
+				if (group->identifier == identifier && group->origin == origin)
+				{
+					return group;
+				}
+			}
+
+			return groups.end();
+		}
+
+		size_t fragmentManager::groupsFrom(const address& origin) const
+		{
+			size_t count = 0;
+
+			for (const auto& group : groups)
+			{
+				if (group.origin == origin)
+				{
+					count++;
+				}
+			}
+
+			return count;
+		}
+
+		void fragmentManager::removeGroup(list<fragmentGroup>::iterator group)
+		{
+			reassemblyMemory -= group->totalSize;
+
+			groups.erase(group);
+
+			return;
+		}
+	}
+}
\ No newline at end of file
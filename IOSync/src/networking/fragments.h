@@ -0,0 +1,245 @@
+#pragma once
+
+// Includes:
+#include "networking.h"
+#include "address.h"
+
+// Standard library:
+#include <vector>
+#include <deque>
+#include <list>
+#include <chrono>
+
+// Namespace(s):
+using namespace std;
+using namespace chrono;
+
+namespace iosync
+{
+	namespace networking
+	{
+		// Typedefs:
+		typedef unsigned short fragmentGroupID;
+		typedef unsigned short fragmentIndex;
+
+		// This is used to describe the total size of a fragmented datagram, as well as fragment offsets.
+		typedef unsigned int fragmentLength;
+
+		// Enumerator(s):
+
+		// These macros are measured in bytes:
+		enum fragmentSizes : size_t
+		{
+			/*
+				This is the largest datagram we'll send before fragmenting.
+				This is kept below the common path-MTU (1500 bytes, minus IP and UDP headers),
+				and below the minimum IPv6 MTU (1280 bytes), so routers don't need to fragment for us.
+			*/
+
+			DEFAULT_MAXIMUM_DATAGRAM_SIZE = 1200,
+
+			// The serialized size of a fragment's description. (Not including the fragment itself)
+			FRAGMENT_HEADER_SIZE = (sizeof(fragmentGroupID) + (sizeof(fragmentIndex) * 2) + (sizeof(fragmentLength) * 2)),
+
+			// The number of bytes reserved for each fragment's header, footer, and meta-data.
+			FRAGMENT_RESERVED_BYTES = 64,
+
+			// The largest datagram we're willing to reassemble.
+			DEFAULT_MAXIMUM_REASSEMBLY_SIZE = 65535,
+
+			// The maximum number of bytes we're willing to hold onto while reassembling.
+			DEFAULT_MAXIMUM_REASSEMBLY_MEMORY = 1024 * 1024,
+		};
+
+		enum fragmentTime : unsigned long long
+		{
+			// The number of milliseconds an incomplete datagram is held before being discarded.
+			DEFAULT_REASSEMBLY_TIMEOUT = DEFAULT_RELIABLE_PACKET_WAIT_TIME,
+		};
+
+		enum fragmentLimits : size_t
+		{
+			// The maximum number of incomplete datagrams a single connection may have at once.
+			DEFAULT_MAXIMUM_GROUPS_PER_CONNECTION = 8,
+		};
+
+		// Structures:
+
+		// This is used to describe the limits of a 'fragmentManager'.
+		struct fragmentMetrics
+		{
+			// Constructor(s):
+			fragmentMetrics
+			(
+				size_t maximumDatagramSize=DEFAULT_MAXIMUM_DATAGRAM_SIZE,
+				size_t maximumReassemblySize=DEFAULT_MAXIMUM_REASSEMBLY_SIZE,
+				size_t maximumReassemblyMemory=DEFAULT_MAXIMUM_REASSEMBLY_MEMORY,
+				size_t maximumGroupsPerConnection=DEFAULT_MAXIMUM_GROUPS_PER_CONNECTION,
+				milliseconds reassemblyTimeout=(milliseconds)DEFAULT_REASSEMBLY_TIMEOUT
+			);
+
+			// Methods:
+
+			// This specifies the number of raw bytes each fragment may carry.
+			inline size_t fragmentPayloadSize() const
+			{
+				return (maximumDatagramSize - FRAGMENT_RESERVED_BYTES);
+			}
+
+			// Fields:
+
+			// The largest datagram that may be sent without fragmentation.
+			size_t maximumDatagramSize;
+
+			// The largest datagram that may be reassembled.
+			size_t maximumReassemblySize;
+
+			// The maximum number of bytes held across every incomplete datagram.
+			size_t maximumReassemblyMemory;
+
+			// The maximum number of incomplete datagrams per remote address.
+			size_t maximumGroupsPerConnection;
+
+			// The amount of time an incomplete datagram may wait for its remaining fragments.
+			milliseconds reassemblyTimeout;
+		};
+
+		// This represents a single datagram that is being reassembled.
+		struct fragmentGroup
+		{
+			// Constructor(s):
+			fragmentGroup(const address& origin, fragmentGroupID identifier, fragmentIndex count, fragmentLength totalSize);
+
+			// Methods:
+			inline bool complete() const
+			{
+				return (received == count);
+			}
+
+			inline milliseconds time() const
+			{
+				return elapsed(snapshot);
+			}
+
+			// Fields:
+
+			// The address this datagram is coming from.
+			address origin;
+
+			// The reassembled contents of the datagram.
+			vector<uqchar> data;
+
+			// The fragments we've already received. (Used to discard duplicates)
+			vector<bool> receivedFragments;
+
+			// A "snapshot" of the time the first fragment arrived.
+			high_resolution_clock::time_point snapshot;
+
+			// The size of the original datagram.
+			fragmentLength totalSize;
+
+			fragmentGroupID identifier;
+
+			// The total number of fragments, and the number we've received.
+			fragmentIndex count, received;
+		};
+
+		// This represents a fully reassembled datagram.
+		struct fragmentedDatagram
+		{
+			// Fields:
+			address origin;
+
+			vector<uqchar> data;
+		};
+
+		// Classes:
+
+		/*
+			This class sits below the message framing ('messageHeader' and 'messageFooter');
+			it splits finished datagrams that are larger than the path-MTU into
+			fragments, and reassembles incoming fragments into the original datagram.
+
+			Fragments are sent as 'MESSAGE_TYPE_FRAGMENT' messages, so they can use the
+			standard reliable-message functionality. Lost fragments are resent individually.
+		*/
+
+		class fragmentManager
+		{
+			public:
+				// Constructor(s):
+				fragmentManager(const fragmentMetrics metrics=fragmentMetrics());
+
+				// Methods:
+
+				// This discards incomplete datagrams that have timed-out.
+				void update();
+
+				// This discards everything currently being reassembled.
+				void clear();
+
+				inline bool shouldFragment(size_t datagramSize) const
+				{
+					return (datagramSize > metrics.maximumDatagramSize);
+				}
+
+				inline fragmentIndex fragmentCount(size_t datagramSize) const
+				{
+					auto payloadSize = metrics.fragmentPayloadSize();
+
+					return (fragmentIndex)((datagramSize + (payloadSize - 1)) / payloadSize);
+				}
+
+				inline fragmentGroupID generateGroupID()
+				{
+					return nextGroupID++;
+				}
+
+				/*
+					This adds a fragment to the datagram it belongs to.
+					If this fragment completes the datagram, the reassembled
+					datagram is placed into the 'completed' container.
+
+					The return value of this command indicates if the fragment was accepted.
+				*/
+
+				bool addFragment(const address& origin, fragmentGroupID identifier, fragmentIndex index, fragmentIndex count, fragmentLength totalSize, fragmentLength offset, const uqchar* data, size_t dataSize);
+
+				// This discards every incomplete datagram coming from 'origin'.
+				void removeConnection(const address& origin);
+
+				inline bool hasCompleted() const
+				{
+					return !completed.empty();
+				}
+
+				// This loads a reassembled datagram into the input-buffer of 'socket'.
+				// The return value of this command indicates if the datagram could be loaded.
+				static bool loadDatagram(QSocket& socket, const fragmentedDatagram& datagram);
+
+				// Fields:
+				fragmentMetrics metrics;
+
+				// Reassembled datagrams waiting to be handled.
+				deque<fragmentedDatagram> completed;
+			protected:
+				// Methods (Protected):
+				list<fragmentGroup>::iterator getGroup(const address& origin, fragmentGroupID identifier);
+
+				size_t groupsFrom(const address& origin) const;
+
+				void removeGroup(list<fragmentGroup>::iterator group);
+
+				// Fields (Protected):
+
+				// Datagrams that are being reassembled.
+				list<fragmentGroup> groups;
+
+				// The number of bytes currently allocated by 'groups'.
+				size_t reassemblyMemory;
+
+				// The next group-identifier used for outgoing datagrams.
+				fragmentGroupID nextGroupID;
+		};
+	}
+}
\ No newline at end of file
@@ -1,6 +1,11 @@
 // Includes:
 #include "messages.h"
 
+// Standard library:
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
 // Namespace(s):
 namespace iosync
 {
@@ -14,17 +19,17 @@ namespace iosync
 		// Nothing so far.
 
 		// Constructor(s):
-		messageHeader::messageHeader(messageType msgType, packetSize_t dataSize) : type(msgType), packetSize(dataSize), directedHere(true)
+		messageHeader::messageHeader(messageType msgType, packetSize_t dataSize, messageFraming framing) : type(msgType), packetSize(dataSize), framing(framing), directedHere(true)
 		{
 			// Nothing so far.
 		}
 
-		messageHeader::messageHeader(messageType msgType, packetSize_t dataSize, QSocket& socket) : type(msgType), packetSize(dataSize), directedHere(true)
+		messageHeader::messageHeader(messageType msgType, packetSize_t dataSize, QSocket& socket) : type(msgType), packetSize(dataSize), framing(DEFAULT_MESSAGE_FRAMING), directedHere(true)
 		{
 			writeTo(socket);
 		}
 
-		messageHeader::messageHeader(messageType msgType, packetSize_t dataSize, QSocket& socket, headerInfo& info_out) : type(msgType), packetSize(dataSize), directedHere(true)
+		messageHeader::messageHeader(messageType msgType, packetSize_t dataSize, QSocket& socket, headerInfo& info_out) : type(msgType), packetSize(dataSize), framing(DEFAULT_MESSAGE_FRAMING), directedHere(true)
 		{
 			writeTo(socket, info_out);
 		}
@@ -32,11 +37,47 @@ namespace iosync
 		// Methods:
 
 		// I/O related:
-		bool messageHeader::readFrom(QSocket& socket, messageFooter& footer)
+		bool messageHeader::readFrom(QSocket& socket, messageFooter& footer, messageFraming framing)
 		{
 			// Local variable(s):
 			bool hasFooter;
 
+			this->framing = framing;
+
+			if (framing == MESSAGE_FRAMING_COMPACT)
+			{
+				// Compact headers hold the footer's contents, so this can be done in one pass:
+				auto flags = socket.read<uqchar>();
+
+				type = (messageType)(flags >> COMPACT_TYPE_SHIFT);
+
+				if (type == COMPACT_TYPE_EXTENDED)
+				{
+					type += (messageType)readVarint(socket);
+				}
+
+				if ((flags & COMPACT_FLAG_RELIABLE) > 0)
+					footer.reliableIdentifier = (packetID)readVarint(socket);
+				else
+					footer.reliableIdentifier = PACKET_ID_UNRELIABLE;
+
+				if ((flags & COMPACT_FLAG_FORWARD_ADDRESS) > 0)
+					footer.forwardAddress.readFrom(socket);
+				else
+					footer.forwardAddress = address();
+
+				footer.serializedSize = 0;
+
+				// Read the size of the data-segment.
+				packetSize = (packetSize_t)readVarint(socket);
+
+				// Check if the packet is being forwarded.
+				directedHere = !footer.forwardAddressSet();
+
+				// Tell the user if a footer was described.
+				return ((flags & (COMPACT_FLAG_RELIABLE | COMPACT_FLAG_FORWARD_ADDRESS)) > 0);
+			}
+
 			// Read the type of message.
 			type = socket.read<messageType>();
 
@@ -63,14 +104,30 @@ namespace iosync
 
 		void messageHeader::writeTo(QSocket& socket, headerInfo& info_out)
 		{
-			// Local variable(s):
-			// Nothing so far.
+			info_out.type = type;
+			info_out.framing = framing;
+
+			if (framing == MESSAGE_FRAMING_COMPACT)
+			{
+				messageHeader::writeDatagramMarker(socket, framing);
+
+				// Compact headers are written by the footer, in front of the data-segment.
+				info_out.entryPoint = socket.writeOffset;
+
+				info_out.packetSize_position = 0;
+				info_out.footerLocation_position = 0;
+
+				return;
+			}
+
+			// The following positions are relative to this.
+			info_out.entryPoint = socket.writeOffset;
 
 			// Write the type of this message.
 			socket.write<messageType>(type);
 
 			// Retrieve the position where we'll write the footer's location.
-			info_out.footerLocation_position = socket.writeOffset;
+			info_out.footerLocation_position = (socket.writeOffset-info_out.entryPoint);
 
 			// By default, messages to not have footers, to specify
 			// one, please use the 'messageFooter' struct and/or
@@ -79,7 +136,7 @@ namespace iosync
 
 			// Retrieve the position where we'll write the
 			// raw-data's size, then write the size in question:
-			info_out.packetSize_position = socket.writeOffset;
+			info_out.packetSize_position = (socket.writeOffset-info_out.entryPoint);
 
 			// This must be placed at the end of the serialized header.
 			socket.write<packetSize_t>(packetSize);
@@ -176,6 +233,13 @@ namespace iosync
 
 		void messageFooter::writeTo(QSocket& socket, const headerInfo information, bool forceAddress)
 		{
+			if (information.framing == MESSAGE_FRAMING_COMPACT)
+			{
+				writeCompactTo(socket, information, forceAddress);
+
+				return;
+			}
+
 			// Update the header:
 
 			// Update the projected "data-segment" size of the header:
@@ -210,5 +274,68 @@ namespace iosync
 
 			return;
 		}
+
+		void messageFooter::writeCompactTo(QSocket& socket, const headerInfo information, bool forceAddress)
+		{
+			// Local variable(s):
+			auto dataSize = (size_t)(socket.writeOffset-information.entryPoint);
+
+			bool isReliable = (reliableIdentifier != PACKET_ID_UNRELIABLE);
+			bool addressAvail = (forceAddress || forwardAddress.isSet());
+
+			uqchar flags = (uqchar)(min<messageType>(information.type, COMPACT_TYPE_EXTENDED) << COMPACT_TYPE_SHIFT);
+
+			if (isReliable)
+				flags |= COMPACT_FLAG_RELIABLE;
+
+			if (addressAvail)
+				flags |= COMPACT_FLAG_FORWARD_ADDRESS;
+
+			// The header needs to be placed in front of the data-segment, so move the data-segment out of the way:
+			uqchar stackBuffer[COMPACT_STACK_BUFFER_SIZE];
+			vector<uqchar> heapBuffer;
+
+			uqchar* data = stackBuffer;
+
+			if (dataSize > COMPACT_STACK_BUFFER_SIZE)
+			{
+				heapBuffer.resize(dataSize);
+
+				data = heapBuffer.data();
+			}
+
+			memcpy(data, socket.outbuffer + information.entryPoint, dataSize);
+
+			// Seek back to the beginning of the message.
+			socket.outSeek(information.entryPoint);
+
+			// Write the header:
+			socket.write<uqchar>(flags);
+
+			if (information.type >= COMPACT_TYPE_EXTENDED)
+			{
+				writeVarint(socket, (information.type - COMPACT_TYPE_EXTENDED));
+			}
+
+			if (isReliable)
+			{
+				writeVarint(socket, reliableIdentifier);
+			}
+
+			if (addressAvail)
+			{
+				forwardAddress.writeTo(socket);
+			}
+
+			writeVarint(socket, dataSize);
+
+			// Write the data-segment back into the output.
+			socket.UwriteBytes(data, dataSize);
+
+			// This footer's contents were written into the header.
+			serializedSize = 0;
+
+			return;
+		}
 	}
 }
\ No newline at end of file
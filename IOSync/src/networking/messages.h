@@ -4,6 +4,9 @@
 #include "networking.h"
 #include "address.h"
 
+// Standard library:
+#include <climits>
+
 // Namespace(s):
 namespace iosync
 {
@@ -15,6 +18,83 @@ namespace iosync
 			FOOTER_LOCATION_NONE = 0,
 		};
 
+		// Compact datagrams begin with this marker; legacy datagrams begin with a 'messageType'.
+		enum framingMarkers : messageType
+		{
+			FRAMING_MARKER_COMPACT = USHRT_MAX,
+
+			// Compact datagrams from connections with an identifier; followed by the identifier. (Variable-length)
+			FRAMING_MARKER_COMPACT_IDENTIFIED = (USHRT_MAX - 1),
+		};
+
+		// The layout of the first byte of a compact header:
+		enum compactHeaderFlags : uqchar
+		{
+			COMPACT_FLAG_RELIABLE = 1,
+			COMPACT_FLAG_FORWARD_ADDRESS = 2,
+
+			// The message's type is stored in the remaining bits.
+			COMPACT_TYPE_SHIFT = 2,
+
+			// Types this large (Or larger) are followed by a variable-length integer.
+			COMPACT_TYPE_EXTENDED = (UCHAR_MAX >> COMPACT_TYPE_SHIFT),
+		};
+
+		// Compact messages with data-segments this small are moved without a heap allocation.
+		enum compactSizes : size_t
+		{
+			COMPACT_STACK_BUFFER_SIZE = 256,
+		};
+
+		// Functions:
+
+		// Variable-length integers; 7 bits per byte, least significant bits first.
+		inline size_t varintSize(unsigned long long value)
+		{
+			size_t size = 1;
+
+			while (value >= 0x80)
+			{
+				value >>= 7;
+
+				size++;
+			}
+
+			return size;
+		}
+
+		inline void writeVarint(QSocket& socket, unsigned long long value)
+		{
+			while (value >= 0x80)
+			{
+				socket.write<uqchar>((uqchar)(value | 0x80));
+
+				value >>= 7;
+			}
+
+			socket.write<uqchar>((uqchar)value);
+
+			return;
+		}
+
+		inline unsigned long long readVarint(QSocket& socket)
+		{
+			// Local variable(s):
+			unsigned long long value = 0;
+
+			for (unsigned shift = 0; shift < (sizeof(value) * CHAR_BIT); shift += 7)
+			{
+				auto data = socket.read<uqchar>();
+
+				value |= ((unsigned long long)(data & 0x7F) << shift);
+
+				if ((data & 0x80) == 0)
+					break;
+			}
+
+			return value;
+		}
+
 		// Structures:
 		 
 		// Forward declaration for 'messageHeader'.
@@ -40,6 +120,12 @@ namespace iosync
 			// The position of the "footer-location pointer" in the serialized header.
 			streamLocation footerLocation_position;
 
+			// Compact headers are written when the message is finished, so the type is held until then.
+			messageType type;
+
+			// The wire-format this message is being written with.
+			messageFraming framing;
+
 			// Methods:
 			inline bool shouldUpdate_packetSize() const
 			{
@@ -69,8 +155,12 @@ namespace iosync
 			void readFrom(QSocket& socket);
 			void readFrom(QSocket& socket, streamLocation position, bool restoreSeekPosition=true);
 
+			// When 'information' describes a compact message, this writes the header as well.
 			void writeTo(QSocket& socket, const headerInfo information, bool forceAddress = false);
 
+			// This writes a compact header in front of the message's data-segment.
+			void writeCompactTo(QSocket& socket, const headerInfo information, bool forceAddress = false);
+
 			inline bool forwardAddressSet() const
 			{
 				return forwardAddress.isSet();
@@ -85,6 +175,7 @@ namespace iosync
 
 			// The serialized size of this footer. This is useful when
 			// passing invalid messages in a "real" packet.
+			// Compact footers are stored in the header, so this is always zero for them.
 			packetSize_t serializedSize;
 		};
 
@@ -155,6 +246,63 @@ namespace iosync
 				return markLocation(socket, position, getRelativeLocation(socket, position));
 			}
 
+			// This writes the marker compact datagrams begin with, if 'socket' is at the beginning of a datagram.
+			// If a 'connection' identifier is specified, it's written with the marker.
+			static inline void writeDatagramMarker(QSocket& socket, messageFraming framing, playerSlot connection=PLAYER_SLOT_NONE)
+			{
+				if (framing == MESSAGE_FRAMING_COMPACT && socket.writeOffset == 0)
+				{
+					if (connection != PLAYER_SLOT_NONE)
+					{
+						socket.write<messageType>(FRAMING_MARKER_COMPACT_IDENTIFIED);
+
+						writeVarint(socket, connection);
+					}
+					else
+					{
+						socket.write<messageType>(FRAMING_MARKER_COMPACT);
+					}
+				}
+
+				return;
+			}
+
+			// This reads the marker at the beginning of a datagram, then reports the datagram's wire-format.
+			// The connection-identifier of the datagram is output as well. ('PLAYER_SLOT_NONE' if one wasn't specified)
+			static inline messageFraming readDatagramFraming(QSocket& socket, playerSlot& connection_out)
+			{
+				// Local variable(s):
+				auto position = socket.readOffset;
+
+				connection_out = PLAYER_SLOT_NONE;
+
+				if (socket.canRead())
+				{
+					switch (socket.read<messageType>())
+					{
+						case FRAMING_MARKER_COMPACT_IDENTIFIED:
+							connection_out = (playerSlot)readVarint(socket);
+
+							return MESSAGE_FRAMING_COMPACT;
+						case FRAMING_MARKER_COMPACT:
+							return MESSAGE_FRAMING_COMPACT;
+					}
+				}
+
+				// Legacy datagrams don't have a marker; seek back.
+				socket.inSeek(position);
+
+				return MESSAGE_FRAMING_LEGACY;
+			}
+
+			static inline messageFraming readDatagramFraming(QSocket& socket)
+			{
+				// Local variable(s):
+				playerSlot connection;
+
+				return readDatagramFraming(socket, connection);
+			}
+
 			static inline bool markBoolean(QSocket& socket, streamLocation position, bool value)
 			{
 				// Store the current write-offset.
@@ -174,7 +322,7 @@ namespace iosync
 			}
 
 			// Constructor(s):
-			messageHeader(messageType msgType = 0, packetSize_t dataSize = 0);
+			messageHeader(messageType msgType = 0, packetSize_t dataSize = 0, messageFraming framing = DEFAULT_MESSAGE_FRAMING);
 
 			// This constructor will immediately write to the socket specified.
 			messageHeader(messageType msgType, packetSize_t dataSize, QSocket& socket);
@@ -190,7 +338,8 @@ namespace iosync
 			// After reading the header, it may output a footer.
 			// For this reason, you need to allocate a footer-object, then pass it in.
 			// The return-value of this command indicates if a footer was found.
-			bool readFrom(QSocket& socket, messageFooter& footer);
+			// The 'framing' argument should be retrieved using 'readDatagramFraming'.
+			bool readFrom(QSocket& socket, messageFooter& footer, messageFraming framing = DEFAULT_MESSAGE_FRAMING);
 
 			/*
 				This will write the serializable contents of this header.
@@ -205,6 +354,9 @@ namespace iosync
 				it will not be required to overwrite.
 				
 				By default, headers do not expect footers.
+
+				Compact headers are not written until the message is finished;
+				this only stores the position-information needed to do so.
 			*/
 
 			void writeTo(QSocket& socket, headerInfo& information_out);
@@ -237,6 +389,9 @@ namespace iosync
 			packetSize_t packetSize;
 			messageType type;
 
+			// The wire-format used to read and write this header.
+			messageFraming framing;
+
 			// Booleans / Flags:
 
 			// This is automatically handled by a footer.
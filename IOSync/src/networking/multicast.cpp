@@ -0,0 +1,193 @@
+// Includes:
+#include "multicast.h"
+
+// Platform-specific:
+#ifdef PLATFORM_WINDOWS
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <sys/types.h>
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+	#include <unistd.h>
+	#include <fcntl.h>
+#endif
+
+// Standard library:
+#include <string>
+#include <cstring>
+
+// Namespace(s):
+namespace iosync
+{
+	namespace networking
+	{
+		// Functions:
+		void closeNativeSocket(nativeSocket handle)
+		{
+			#ifdef PLATFORM_WINDOWS
+				closesocket((SOCKET)handle);
+			#else
+				::close(handle);
+			#endif
+
+			return;
+		}
+
+		void disableBlocking(nativeSocket handle)
+		{
+			#ifdef PLATFORM_WINDOWS
+				u_long nonBlocking = 1;
+
+				ioctlsocket((SOCKET)handle, FIONBIO, &nonBlocking);
+			#else
+				fcntl(handle, F_SETFL, (fcntl(handle, F_GETFL, 0) | O_NONBLOCK));
+			#endif
+
+			return;
+		}
+
+		bool nativeReceive(nativeSocket handle, QSocket& socket, address& sender_out)
+		{
+			// Local variable(s):
+			sockaddr_in sender;
+			socklen_t senderLength = sizeof(sender);
+
+			char senderIP[INET_ADDRSTRLEN];
+
+			auto received = recvfrom(handle, (char*)socket.inbuffer, (int)socket._bufferlength, 0, (sockaddr*)&sender, &senderLength);
+
+			if (received <= 0)
+				return false;
+
+			if (inet_ntop(AF_INET, &sender.sin_addr, senderIP, sizeof(senderIP)) == nullptr)
+				return false;
+
+			sender_out = address((nonNativeIP)senderIP, ntohs(sender.sin_port));
+
+			socket.inbufferlen = (size_t)received;
+
+			// Seek back to the beginning of the input.
+			socket.resetRead();
+
+			return true;
+		}
+
+		size_t nativeSend(nativeSocket handle, QSocket& socket, const address& remote)
+		{
+			// Local variable(s):
+
+			// Use the textual representation, so we don't depend on the byte-order of 'addressIP'.
+			auto remoteIP = QSocket::representIP(remote.IP);
+
+			sockaddr_in destination;
+
+			ZeroVariable(destination);
+
+			if (inet_pton(AF_INET, remoteIP.c_str(), &destination.sin_addr) != 1)
+				return 0;
+
+			destination.sin_family = AF_INET;
+			destination.sin_port = htons(remote.port);
+
+			auto sent = sendto(handle, (const char*)socket.outbuffer, (int)socket.writeOffset, 0, (const sockaddr*)&destination, sizeof(destination));
+
+			return ((sent > 0) ? (size_t)sent : 0);
+		}
+
+		// Classes:
+
+		// multicastReceiver:
+
+		// Constructor(s):
+		multicastReceiver::multicastReceiver() : handle(0), isOpen(false) { /* Nothing so far. */ }
+
+		// Destructor(s):
+		multicastReceiver::~multicastReceiver()
+		{
+			leave();
+		}
+
+		// Methods:
+		bool multicastReceiver::join(const address& group)
+		{
+			// Local variable(s):
+
+			// Use the textual representation, so we don't depend on the byte-order of 'addressIP'.
+			auto groupIP = QSocket::representIP(group.IP);
+
+			sockaddr_in local;
+			ip_mreq request;
+
+			int reuse = 1;
+
+			leave();
+
+			ZeroVariable(local);
+			ZeroVariable(request);
+
+			if (inet_pton(AF_INET, groupIP.c_str(), &request.imr_multiaddr) != 1)
+				return false;
+
+			request.imr_interface.s_addr = htonl(INADDR_ANY);
+
+			local.sin_family = AF_INET;
+			local.sin_port = htons(group.port);
+			local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+			auto newHandle = (nativeSocket)::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+			#ifdef PLATFORM_WINDOWS
+				if ((SOCKET)newHandle == INVALID_SOCKET)
+					return false;
+			#else
+				if (newHandle < 0)
+					return false;
+			#endif
+
+			// Several receivers on the same machine may share a group. (This allows testing with loopback)
+			setsockopt(newHandle, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+			if (bind(newHandle, (const sockaddr*)&local, sizeof(local)) != 0 || setsockopt(newHandle, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&request, sizeof(request)) != 0)
+			{
+				closeNativeSocket(newHandle);
+
+				return false;
+			}
+
+			// Received datagrams are polled, so this socket can't block.
+			disableBlocking(newHandle);
+
+			this->handle = newHandle;
+			this->group = group;
+
+			isOpen = true;
+
+			// Return the default response.
+			return true;
+		}
+
+		void multicastReceiver::leave()
+		{
+			if (isOpen)
+			{
+				closeNativeSocket(handle);
+
+				group = address();
+
+				isOpen = false;
+			}
+
+			return;
+		}
+
+		bool multicastReceiver::receive(QSocket& socket, address& sender_out)
+		{
+			if (!isOpen)
+				return false;
+
+			return nativeReceive(handle, socket, sender_out);
+		}
+	}
+}
\ No newline at end of file
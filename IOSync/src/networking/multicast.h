@@ -0,0 +1,85 @@
+#pragma once
+
+// Includes:
+#include "networking.h"
+#include "address.h"
+
+// Namespace(s):
+namespace iosync
+{
+	namespace networking
+	{
+		// Typedefs:
+		#ifdef PLATFORM_WINDOWS
+			typedef UINT_PTR nativeSocket;
+		#else
+			typedef int nativeSocket;
+		#endif
+
+		// Functions:
+		void closeNativeSocket(nativeSocket handle);
+
+		// Native sockets are polled, so they can't block.
+		void disableBlocking(nativeSocket handle);
+
+		// This loads the next datagram 'handle' received into the input-buffer of 'socket'.
+		// The return value of this command indicates if a datagram was received.
+		bool nativeReceive(nativeSocket handle, QSocket& socket, address& sender_out);
+
+		// This sends the output of 'socket' to 'remote' using 'handle'. The number of bytes sent is returned.
+		size_t nativeSend(nativeSocket handle, QSocket& socket, const address& remote);
+
+		// Classes:
+
+		/*
+			This is used by clients to receive datagrams a server sends to a multicast group.
+
+			'QSocket' doesn't support joining multicast groups, so this uses a native socket.
+			Received datagrams are loaded into the input-buffer of a 'QSocket',
+			so they may be handled like any other datagram. (See 'fragmentManager')
+
+			Multicast datagrams are sent with the default time-to-live, so they don't leave the local network.
+		*/
+
+		class multicastReceiver
+		{
+			public:
+				// Constructor(s):
+				multicastReceiver();
+
+				// Destructor(s):
+				~multicastReceiver();
+
+				// Methods:
+
+				// The return value of this command indicates if 'group' was joined.
+				bool join(const address& group);
+
+				void leave();
+
+				inline bool joined() const
+				{
+					return isOpen;
+				}
+
+				/*
+					This loads the next datagram sent to our group into the input-buffer of 'socket'.
+					The return value of this command indicates if a datagram was received.
+					The sender of the datagram is output using 'sender_out'.
+				*/
+
+				bool receive(QSocket& socket, address& sender_out);
+
+				// Fields:
+
+				// The group we've joined.
+				address group;
+			protected:
+				// Fields (Protected):
+				nativeSocket handle;
+
+				// Booleans / Flags:
+				bool isOpen;
+		};
+	}
+}
\ No newline at end of file
@@ -8,12 +8,18 @@
 #include "player.h"
 #include "packets.h"
 #include "messages.h"
+#include "fragments.h"
+#include "playerRegistry.h"
+#include "multicast.h"
 
 #include "../exceptions.h"
 
 // Standard library:
 #include <string>
 #include <stdexcept>
+#include <queue>
+#include <functional>
+#include <unordered_map>
 
 // Namespace(s):
 using namespace std;
@@ -105,6 +111,25 @@ namespace iosync
 					// This is used to confirm reliable packets.
 					MESSAGE_TYPE_CONFIRM_PACKET,
 
+					// This is used to send a piece of a datagram that was too large to send at once.
+					MESSAGE_TYPE_FRAGMENT,
+
+					// This is used by servers to point joining players at a relay "node".
+					MESSAGE_TYPE_REDIRECT,
+
+					/*
+						This is used to negotiate multicast delivery. Servers send this reliably to announce their group,
+						and periodically to the group itself. Players reply with this once the group has reached them.
+					*/
+
+					MESSAGE_TYPE_MULTICAST,
+
+					// This is used by players to tell the server which routing channels they need messages from.
+					MESSAGE_TYPE_SUBSCRIBE,
+
+					// This is used by servers aggregating their players' input; it starts each combined "frame" datagram.
+					MESSAGE_TYPE_FRAME,
+
 					// Custom message-types should start at this location.
 					MESSAGE_TYPE_CUSTOM_LOCATION,
 				};
@@ -181,12 +206,18 @@ namespace iosync
 				virtual bool open();
 
 				// Destructor(s):
+				virtual ~networkEngine()
+				{
+					// Nothing so far.
+				}
+
 				virtual bool close();
 
 				// Methods (Public):
 				virtual void update();
 
-				bool updateSocket(QSocket& socket);
+				// This loads the next datagram into the input-buffer of 'socket'. The return value indicates if one was received.
+				virtual bool updateSocket(QSocket& socket);
 
 				inline bool updateSocket()
 				{
@@ -202,9 +233,29 @@ namespace iosync
 					return;
 				}
 
+				// This re-sends a reliable packet that hasn't been confirmed yet.
+				virtual size_t resendPacket(QSocket& socket, outbound_packet& packetInTransit);
+
 				packetID generateReliableID();
 
-				headerInfo beginMessage(QSocket& socket, messageType msgType);
+				// Messages are written using 'outputFraming', rather than our current wire-format.
+				headerInfo beginMessage(QSocket& socket, messageType msgType, messageFraming outputFraming);
+
+				inline headerInfo beginMessage(QSocket& socket, messageType msgType)
+				{
+					return beginMessage(socket, msgType, framing);
+				}
+
+				/*
+					This marks the message last started in the output as belonging to 'channels'.
+					When every message in a broadcast has been marked, the server only sends it
+					to players subscribed to one of those channels. (See 'MESSAGE_TYPE_SUBSCRIBE')
+				*/
+
+				void routeMessage(subscriptionChannels channels);
+
+				// This retrieves the channels of the current output. ('SUBSCRIPTION_CHANNELS_ALL' if any message wasn't marked)
+				subscriptionChannels outputChannels() const;
 
 				void finishMessage(QSocket& socket, const headerInfo header_Information);
 				messageFooter finishMessage(QSocket& socket, const headerInfo header_information, const address& forwardAddress, const packetID ID=PACKET_ID_UNRELIABLE);
@@ -273,6 +324,20 @@ namespace iosync
 				virtual size_t sendMessage(QSocket& socket, const address& remote, bool resetLength=true, networkDestinationCode destinationCode=DEFAULT_DESTINATION);
 				virtual size_t sendMessage(networkDestinationCode destination=DEFAULT_DESTINATION, bool resetLength=true);
 
+				// This sends the current output to 'remote', fragmenting it if it's too large.
+				// This should only be called after the output has been finalized.
+				size_t sendOutput(QSocket& socket, const address& remote, bool resetLength=true);
+
+				// This sends the current output to 'remote' as it is. (Used by 'sendOutput')
+				virtual size_t sendDatagram(QSocket& socket, const address& remote, bool resetLength=true);
+
+				// The address of the datagram last loaded into 'socket'. (See 'updateSocket')
+				virtual address senderAddress(const QSocket& socket) const;
+
+				// This splits the current output into reliable 'MESSAGE_TYPE_FRAGMENT' messages, then sends them to 'remote'.
+				// If 'resetLength' is disabled, the original output will be restored afterward.
+				size_t sendFragments(QSocket& socket, const address& remote, bool resetLength=true);
+
 				inline size_t sendMessage(QSocket& socket, outbound_packet packet, networkDestinationCode destination, bool alreadyInOutput=true)
 				{
 					packet.destinationCode = destination;
@@ -294,6 +359,9 @@ namespace iosync
 
 				virtual player* getPlayer(QSocket& socket);
 
+				// This specifies the identifier written with outgoing datagrams. ('PLAYER_SLOT_NONE' if one hasn't been assigned)
+				virtual playerSlot getConnectionID() const;
+
 				virtual bool alone() const = 0;
 				virtual size_t connections() const = 0;
 
@@ -302,6 +370,12 @@ namespace iosync
 					return !alone();
 				}
 
+				// The number of messages handled during the last update.
+				inline size_t messagesHandled() const
+				{
+					return handledMessages;
+				}
+
 				// Reliable message related:
 
 				// This command is called every time a reliable message is found.
@@ -323,7 +397,11 @@ namespace iosync
 				// This may be used to manually remove a 'player' object from an
 				// 'outbound_packet' object's internal reference-container.
 				// This command is considered "unsafe", as it may rely upon undefined behavior under certain conditions.
-				bool removeReliablePacket(player* p, outbound_packet& packetInTransit);
+				bool removeReliablePacket(player* p, outboundPacketList::iterator packetInTransit);
+
+				// This retrieves the slot of the player at 'remoteAddress'.
+				// By default, players aren't assigned slots; 'PLAYER_SLOT_NONE' is returned.
+				virtual playerSlot getPlayerSlot(const address& remoteAddress) const;
 
 				// This method passes the message represented by the header specified.
 				// This will only pass the data-segment of the message; the footer will not be passed.
@@ -356,6 +434,10 @@ namespace iosync
 				// The return value of this method indicates the number of messages that were received.
 				size_t handleMessages(QSocket& socket);
 
+				// This handles every message in the socket's current input.
+				// The return value of this method indicates the number of messages that were parsed.
+				size_t handleDatagram(QSocket& socket);
+
 				// Parsing/deserialization related:
 
 				// When overriding this method, please "call up" to your super-class's implementation.
@@ -369,9 +451,13 @@ namespace iosync
 				}
 
 				// Serialization related:
-				void serializeConnectionMessage(QSocket& socket, wstring name);
+				void serializeConnectionMessage(QSocket& socket, wstring name, connectionType type=CONNECTION_TYPE_PLAYER);
 				void serializeLeaveNotice(QSocket& socket, disconnectionReason reason);
 				void serializePacketConfirmationMessage(QSocket& socket, packetID ID);
+				void serializeFragment(QSocket& socket, fragmentGroupID identifier, fragmentIndex index, fragmentIndex count, fragmentLength totalSize, fragmentLength offset);
+
+				// This is appended to connection messages, and their confirmations.
+				void serializeFraming(QSocket& socket);
 
 				// Message generation:
 
@@ -396,11 +482,32 @@ namespace iosync
 					return finishReliableMessage(socket, realAddress, info, forwardAddress);
 				}
 
-				inline outbound_packet generateConnectionMessage(QSocket& socket, wstring name, const address& realAddress = address(), const address& forwardAddress = address())
+				inline outbound_packet generateConnectionMessage(QSocket& socket, wstring name, const address& realAddress = address(), const address& forwardAddress = address(), connectionType type = CONNECTION_TYPE_PLAYER)
 				{
 					auto info = beginMessage(socket, MESSAGE_TYPE_JOIN);
 
-					serializeConnectionMessage(socket, name);
+					serializeConnectionMessage(socket, name, type);
+
+					return finishReliableMessage(socket, realAddress, info, forwardAddress);
+				}
+
+				inline outbound_packet generateMulticastMessage(QSocket& socket, const address& group, const address& realAddress = address(), const address& forwardAddress = address())
+				{
+					// Local variable(s):
+					auto groupAddress = group;
+
+					auto info = beginMessage(socket, MESSAGE_TYPE_MULTICAST);
+
+					groupAddress.writeTo(socket);
+
+					return finishReliableMessage(socket, realAddress, info, forwardAddress);
+				}
+
+				inline outbound_packet generateSubscriptionMessage(QSocket& socket, subscriptionChannels channels, const address& realAddress = address(), const address& forwardAddress = address())
+				{
+					auto info = beginMessage(socket, MESSAGE_TYPE_SUBSCRIBE);
+
+					socket.write<subscriptionChannels>(channels);
 
 					return finishReliableMessage(socket, realAddress, info, forwardAddress);
 				}
@@ -421,6 +528,23 @@ namespace iosync
 
 				virtual packetID parsePacketConfirmationMessage(QSocket& socket, const address& remoteAddress, const messageHeader& header, const messageFooter& footer);
 
+				// The return value of this command indicates if the fragment was accepted.
+				bool parseFragment(QSocket& socket, const address& remoteAddress, const messageHeader& header);
+
+				/*
+					This reads the wire-format appended to a connection message, if one was written.
+					Remote connections which predate this negotiation are assumed to use the legacy format.
+					The 'parsePosition' argument should be the beginning of the message's data-segment.
+				*/
+
+				messageFraming parseFraming(QSocket& socket, const messageHeader& header, streamLocation parsePosition);
+
+				// This reads the connection-identifier appended to a connection message, if one was written.
+				playerSlot parseConnectionID(QSocket& socket, const messageHeader& header, streamLocation parsePosition);
+
+				// This reads the connection-type appended to a connection message. (Players don't write one)
+				connectionType parseConnectionType(QSocket& socket, const messageHeader& header, streamLocation parsePosition);
+
 				// Sending related:
 				inline size_t sendPing(QSocket& socket, networkDestinationCode destination=DEFAULT_DESTINATION, bool resetLength=true)
 				{
@@ -447,6 +571,15 @@ namespace iosync
 				// The primary socket of this "engine".
 				QSocket socket;
 
+				// This is used to split and reassemble datagrams larger than the path-MTU.
+				fragmentManager fragments;
+
+				// The wire-format used for outgoing messages. This is negotiated when connecting.
+				messageFraming framing;
+
+				// The latest wire-format this "engine" is willing to negotiate.
+				messageFraming maximumFraming;
+
 				// Booleans / Flags:
 
 				// This variable describes if this "engine" is able to act as a "node".
@@ -458,11 +591,50 @@ namespace iosync
 				// Message generation:
 
 				// This is used to finalize a packet, before sending it off.
-				void finalizeOutput(QSocket& s, networkDestinationCode destinationCode=DEFAULT_DESTINATION);
+				void finalizeOutput(QSocket& s, networkDestinationCode destinationCode, messageFraming outputFraming);
+
+				inline void finalizeOutput(QSocket& s, networkDestinationCode destinationCode=DEFAULT_DESTINATION)
+				{
+					finalizeOutput(s, destinationCode, framing);
+
+					return;
+				}
+
+				// Reliable packet related:
+
+				// This writes 'packetInTransit' as its own datagram, then finalizes it in the packet's wire-format.
+				// Packets stored before our wire-format changed are re-sent as they were first written.
+				void writeResend(QSocket& socket, outbound_packet& packetInTransit, networkDestinationCode destinationCode);
+
+				// Subscription related:
+				inline void resetOutputRoute()
+				{
+					outputRoute = 0;
+
+					outputMessages = 0;
+					routedMessages = 0;
+
+					return;
+				}
 
 				// Parsing/deserialization related:
 				virtual networkDestinationCode parseMeta(QSocket& socket, const address& remoteAddress, const messageHeader& header);
 
+				// This retrieves the routing channels of an incoming message, without reading it. (Asks 'parentProgram' about custom messages)
+				subscriptionChannels parseMessageChannels(QSocket& socket, const messageHeader& header);
+
+				// Reliable packet related:
+
+				// These are called as packets are added to, and removed from 'packetsInTransit'.
+				virtual void onPacketAdded(outboundPacketList::iterator packetInTransit);
+				virtual void onPacketRemoved(outboundPacketList::iterator packetInTransit);
+
+				// This is called when the connection in 'slot' no longer needs to confirm a packet.
+				virtual void onPacketReleased(outboundPacketList::iterator packetInTransit, playerSlot slot);
+
+				// This removes a packet from 'packetsInTransit', then retrieves the packet after it.
+				outboundPacketList::iterator erasePacket(outboundPacketList::iterator packetInTransit);
+
 				// Fields (Protected):
 
 				// A reference to the 'application' controlling this object.
@@ -472,13 +644,32 @@ namespace iosync
 				networkMetrics metrics;
 
 				// A list of outbound packets in transit.
-				list<outbound_packet> packetsInTransit;
+				outboundPacketList packetsInTransit;
+
+				// The packets in 'packetsInTransit', indexed by identifier; this keeps confirmations from searching the list.
+				unordered_map<packetID, outboundPacketList::iterator> packetIndex;
 
 				// The next 'packetID' used for reliable packet-handling.
 				packetID nextReliableID;
 
+				// The connection-identifier of the datagram currently being handled. ('PLAYER_SLOT_NONE' if unspecified)
+				playerSlot inputConnection = PLAYER_SLOT_NONE;
+
+				// The channels marked in the current output. (See 'routeMessage')
+				subscriptionChannels outputRoute = 0;
+
+				// The number of messages started in the current output, and how many of them were marked.
+				size_t outputMessages = 0;
+				size_t routedMessages = 0;
+
+				// The number of messages handled during the last update. (See 'messagesHandled')
+				size_t handledMessages = 0;
+
 				// Booleans / Flags:
 
+				// When set, the rest of the datagram being handled is skipped.
+				bool skipDatagram = false;
+
 				// This field specifies if this "engine" is the "master server".
 				bool isMaster;
 		};
@@ -515,6 +706,9 @@ namespace iosync
 
 				virtual void updatePacketsInTransit(QSocket& socket) override;
 
+				// Everything we send is routed through our host.
+				virtual size_t resendPacket(QSocket& socket, outbound_packet& packetInTransit) override;
+
 				virtual bool onForwardPacket(QSocket& socket, streamLocation startPosition, const address& remoteAddress, const messageHeader& header, const messageFooter& footer) override;
 
 				// Parsing/deserialization related:
@@ -571,6 +765,9 @@ namespace iosync
 					return networkEngine::sendMessage(socket, generateConnectionMessage(socket, playerName, socket, forwardAddress), destination, resetLength);
 				}
 
+				// This sets the routing channels we need messages from, then tells the server. (If connected)
+				void subscribe(QSocket& socket, subscriptionChannels channels);
+
 				// Message generation:
 				inline outbound_packet generateLeaveNotice(QSocket& socket, disconnectionReason reason, const address& forwardAddress = address())
 				{
@@ -586,6 +783,9 @@ namespace iosync
 				// Connection management functionality:
 				virtual player* getPlayer(QSocket& socket) override;
 
+				// Once connected, this is the identifier the server assigned to us.
+				virtual playerSlot getConnectionID() const override;
+
 				virtual bool alone() const;
 				virtual size_t connections() const;
 
@@ -614,15 +814,43 @@ namespace iosync
 
 				address master;
 
+				// When a server redirects us to a relay "node", this holds the node's address until we've reconnected.
+				address redirection;
+
+				// Used to receive messages the server sends to its multicast group.
+				multicastReceiver multicast;
+
+				// The latest input "frame" received from an aggregating server. (See 'serverNetworkEngine::aggregateFrames')
+				frameNumber lastFrame = 0;
+
 				// Booleans / Flags:
 				bool connected = false;
+
+				// This specifies if 'lastFrame' has been received yet.
+				bool receivedFrame = false;
+
+				// This specifies if we've told the server its multicast group reaches us.
+				bool multicastConfirmed = false;
 			protected:
 				// Methods (Protected):
 
+				// This handles every datagram the server has sent to our multicast group.
+				size_t handleMulticast(QSocket& socket);
+
+				// Booleans / Flags:
+
+				// This is set while handling datagrams received from our multicast group.
+				bool receivingMulticast = false;
+
 				// Parsing/deserialization related:
 				//virtual networkDestinationCode parseMeta(QSocket& socket, const address& remoteAddress, const messageHeader& header) override;
 		};
 
+		/*
+			Servers handle every player using one socket, on the thread that updates the 'application'.
+			Relays may be split across several threads instead; see 'relayShardEngine'.
+		*/
+
 		class serverNetworkEngine : public networkEngine
 		{
 			public:
@@ -644,13 +872,28 @@ namespace iosync
 				// Destructor(s):
 				virtual bool close() override;
 
-				bool open(addressPort port=DEFAULT_PORT);
+				virtual bool open(addressPort port=DEFAULT_PORT);
 
 				// Methods (Public):
 				virtual void update() override;
 
 				virtual void updatePacketsInTransit(QSocket& socket) override;
 
+				// Packets sent to several players are only re-sent to those who haven't confirmed them.
+				virtual size_t resendPacket(QSocket& socket, outbound_packet& packetInTransit) override;
+
+				virtual playerSlot getPlayerSlot(const address& remoteAddress) const override;
+
+				// This produces the slots of every player, other than 'excluded'. ('nullptr' excludes nobody)
+				inline recipientSet recipients(const player* excluded=nullptr) const
+				{
+					return registry.recipients(excluded);
+				}
+
+				// This produces the slots of every player subscribed to 'channels', other than 'excluded'.
+				recipientSet subscribers(subscriptionChannels channels, const player* excluded=nullptr) const;
+
+				// This pings players, and disconnects those who've timed out. Only players whose deadlines have passed are visited.
 				void checkClientTimeouts(QSocket& socket);
 
 				inline void checkClientTimeouts()
@@ -658,7 +901,10 @@ namespace iosync
 					return checkClientTimeouts(this->socket);
 				}
 
-				size_t broadcastMessage(QSocket& socket, playerList players, networkDestinationCode destinationCode=DESTINATION_ALL, bool resetLength=true);
+				size_t broadcastMessage(QSocket& socket, const playerList& players, networkDestinationCode destinationCode=DESTINATION_ALL, bool resetLength=true);
+
+				// This sends the output to every player in 'players', other than 'excluded'. ('nullptr' excludes nobody)
+				size_t broadcastMessage(QSocket& socket, const playerList& players, const player* excluded, networkDestinationCode destinationCode=DESTINATION_ALL, bool resetLength=true);
 				size_t broadcastMessage(QSocket& socket, networkDestinationCode destinationCode=DESTINATION_ALL, bool resetLength=true) override;
 
 				inline size_t sendMessageTo(QSocket& socket, player* p)
@@ -691,9 +937,19 @@ namespace iosync
 
 				// This sends a blank 'MESSAGE_TYPE_JOIN' message reliably to the address specified.
 				// This is used to notify a player that their connection request has been accepted.
-				inline outbound_packet generatePlayerConfirmationMessage(QSocket& socket, const address& realAddress = address(), const address& forwardAddress = address())
+				// If a 'connectionID' is specified, the player may use it to identify their datagrams.
+				inline outbound_packet generatePlayerConfirmationMessage(QSocket& socket, const address& realAddress = address(), const address& forwardAddress = address(), playerSlot connectionID = PLAYER_SLOT_NONE)
 				{
-					return finishReliableMessage(socket, realAddress, beginMessage(socket, MESSAGE_TYPE_JOIN), forwardAddress);
+					auto info = beginMessage(socket, MESSAGE_TYPE_JOIN);
+
+					serializeFraming(socket);
+
+					if (connectionID != PLAYER_SLOT_NONE)
+					{
+						socket.write<playerSlot>(connectionID);
+					}
+
+					return finishReliableMessage(socket, realAddress, info, forwardAddress);
 				}
 
 				inline outbound_packet generateLeaveNotice(QSocket& socket, disconnectionReason reason, player* p)
@@ -737,15 +993,26 @@ namespace iosync
 					return connectedToOthers(); // !alone();
 				}
 
-				// This command allows you to retrieve a player-entry from the 'players' list.
+				// These commands allow you to retrieve a player-entry from the 'players' list.
+				// If the datagram being handled identified its sender, that player is checked first.
 				inline player* getPlayer(const address& addr) const
 				{
-					return networkEngine::getPlayer(players, addr);
+					auto p = registry.at(inputConnection);
+
+					if (p != nullptr && p->remoteAddress == addr)
+						return p;
+
+					return registry.get(addr);
 				}
 
 				inline player* getPlayer(const address& addr, const address& vaddr) const
 				{
-					return networkEngine::getPlayer(players, addr, vaddr);
+					auto p = registry.at(inputConnection);
+
+					if (p != nullptr && p->remoteAddress == addr && p->vaddr() == vaddr)
+						return p;
+
+					return registry.get(addr, vaddr);
 				}
 
 				inline bool playerJoined(const address& addr) const
@@ -753,6 +1020,22 @@ namespace iosync
 					return (getPlayer(addr) != nullptr); //networkEngine::playerJoined(players, addr);
 				}
 
+				/*
+					This joins the server at 'parentAddress' as a relay "node".
+					The parent is then treated as one of our players; everything
+					our players broadcast is sent up, and everything the parent
+					broadcasts is sent down. This lets sessions grow past the
+					upload bandwidth of a single host.
+				*/
+
+				bool joinParent(QSocket& socket, const address& parentAddress, const wstring& name);
+
+				// This counts the players connected directly, rather than through a relay "node".
+				size_t directPlayers() const;
+
+				// This retrieves the "node" new players should be redirected to. ('nullptr' if there are none)
+				player* getRedirectionNode() const;
+
 				// The return values of these commands indicate if they were successful:
 				bool connectPlayer(QSocket& socket, player* p);
 				bool disconnectPlayer(QSocket& socket, player* p, disconnectionReason reason=DISCONNECTION_REASON_ACCEPT);
@@ -762,6 +1045,11 @@ namespace iosync
 				// This routine does not delete, or otherwise mutate the input.
 				void onPlayerRemoved(player* p);
 
+				// Outgoing messages may be sent to every player, so this
+				// selects the latest wire-format every player supports.
+				// If the format changes, the aggregated frame is sent first. (See 'sendFrame')
+				void updateFraming();
+
 				// This will force-disconnect all connected players.
 				void forceDisconnectPlayers(QSocket& socket, disconnectionReason reason=DISCONNECTION_REASON_FORCE, bool reliable=false);
 
@@ -791,7 +1079,12 @@ namespace iosync
 				// The only exception being, when an explicit removal is done with intent to externally manage the object.
 				inline void addPlayer(player* p)
 				{
-					players.push_back(p);
+					p->position = players.insert(players.end(), p);
+
+					registry.add(p);
+
+					// Start checking on this player.
+					scheduleTimer(p);
 
 					return;
 				}
@@ -799,8 +1092,8 @@ namespace iosync
 				// This will not delete the 'player' object in question.
 				inline void removePlayer(player* p, bool autoRemove=true)
 				{
-					if (autoRemove)
-						players.remove(p);
+					if (autoRemove && registry.at(p->slot) == p)
+						players.erase(p->position);
 
 					onPlayerRemoved(p);
 
@@ -809,11 +1102,104 @@ namespace iosync
 
 				// Fields:
 				playerList players;
+
+				// The server this "node" relays for. ('nullptr' if this is the master)
+				player* parent = nullptr;
+
+				// Once this many players are connected directly, new players are redirected to "nodes". (Zero disables this)
+				size_t maximumDirectPlayers = 0;
+
+				/*
+					If set, 'DESTINATION_ALL' and 'DESTINATION_EVERYONE' datagrams are sent to this multicast group once,
+					rather than to every player that has confirmed the group reaches them. Reliable messages are still
+					confirmed by each player, and lost messages are re-sent to those players directly.
+				*/
+
+				address multicastGroup;
+
+				/*
+					When set, unreliable messages relayed with 'DESTINATION_EVERYONE' are held until the end of our update.
+					They're then sent to every player as one numbered "frame" datagram, rather than one datagram per sender.
+					Players discard frames older than the latest they've received.
+				*/
+
+				bool aggregateFrames = false;
 			protected:
+				// Structures:
+
+				// Each player has one of these queued at a time; see 'scheduleTimer'.
+				struct playerTimer
+				{
+					// Constructor(s):
+					playerTimer(high_resolution_clock::time_point deadline, playerSlot slot);
+
+					// Operators:
+					inline bool operator>(const playerTimer& timer) const
+					{
+						return (deadline > timer.deadline);
+					}
+
+					// Fields:
+					high_resolution_clock::time_point deadline;
+
+					playerSlot slot;
+				};
+
+				// Typedefs:
+				typedef priority_queue<playerTimer, vector<playerTimer>, greater<playerTimer>> timerQueue;
+
 				// Methods (Protected):
 
+				// This queues the next time 'p' needs to be pinged, or checked for a time-out.
+				void scheduleTimer(player* p);
+
+				// Reliable packet related:
+
+				// Packets are listed under each player that needs to confirm them, and under the players they're sent to directly.
+				virtual void onPacketAdded(outboundPacketList::iterator packetInTransit) override;
+				virtual void onPacketRemoved(outboundPacketList::iterator packetInTransit) override;
+				virtual void onPacketReleased(outboundPacketList::iterator packetInTransit, playerSlot slot) override;
+
+				void linkPacket(player* p, outboundPacketList::iterator packetInTransit);
+				void unlinkPacket(player* p, outboundPacketList::iterator packetInTransit);
+
+				// This sends the messages aggregated this update as one "frame". (See 'aggregateFrames')
+				size_t sendFrame(QSocket& socket);
+
+				// Multicast related:
+				void announceMulticast(QSocket& socket, player* p);
+				void sendMulticastProbe(QSocket& socket);
+
+				// This sends the finalized output to our multicast group. The return value indicates if this was done.
+				bool sendMulticast(QSocket& socket, const player* excluded, subscriptionChannels channels, size_t& sent_out);
+
+				// This tells a joining player to connect to 'node' instead.
+				void sendRedirect(QSocket& socket, const address& remoteAddress, player* node);
+
+				// This relays the datagram in the input-buffer of 'socket' to our players, other than 'source'. ('nullptr' if unknown)
+				virtual void relayDatagram(QSocket& socket, networkDestinationCode destinationCode, player* source);
+
 				// Parsing/deserialization related:
 				virtual networkDestinationCode parseMeta(QSocket& socket, const address& remoteAddress, const messageHeader& header) override;
+
+				// Fields (Protected):
+
+				// Indexes 'players' by address, and assigns each player a slot.
+				playerRegistry registry;
+
+				// The next deadline of each player, earliest first. Entries left by removed players are skipped.
+				timerQueue timers;
+
+				// The messages aggregated for the next "frame", and the number of that frame.
+				vector<uqchar> frameOutput;
+
+				frameNumber nextFrame = 0;
+
+				// The number of messages in 'frameOutput', and the routing state of those messages. (See 'routeMessage')
+				size_t frameMessages = 0;
+				size_t frameRoutedMessages = 0;
+
+				subscriptionChannels frameRoute = 0;
 		};
 	}
 
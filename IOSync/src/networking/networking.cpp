@@ -7,6 +7,8 @@
 #include "../application/application.h"
 
 // Standard library:
+#include <algorithm>
+
 //#include <iostream>
 
 //#include <queue>
@@ -196,7 +198,7 @@ namespace iosync
 
 		// Constructor(s):
 		networkEngine::networkEngine(application& parent, const networkMetrics netMetrics)
-			: parentProgram(parent), metrics(netMetrics), isHostNode(false), isMaster(false), nextReliableID(PACKET_ID_FIRST) { /* Nothing so far. */ }
+			: parentProgram(parent), metrics(netMetrics), framing(DEFAULT_MESSAGE_FRAMING), maximumFraming(MESSAGE_FRAMING_LATEST), isHostNode(false), isMaster(false), nextReliableID(PACKET_ID_FIRST) { /* Nothing so far. */ }
 
 		bool networkEngine::open()
 		{
@@ -214,6 +216,13 @@ namespace iosync
 
 			// Clear the list of packets in transit.
 			packetsInTransit.clear();
+			packetIndex.clear();
+
+			// Discard any partially reassembled datagrams.
+			fragments.clear();
+
+			// The next connection will need to negotiate its wire-format.
+			framing = DEFAULT_MESSAGE_FRAMING;
 
 			// Return the default response.
 			return true;
@@ -237,7 +246,10 @@ namespace iosync
 
 			updatePacketsInTransit();
 
-			handleMessages(this->socket);
+			// Discard any incomplete datagrams that have timed-out.
+			fragments.update();
+
+			handledMessages = handleMessages(this->socket);
 
 			return;
 		}
@@ -251,7 +263,7 @@ namespace iosync
 
 		void networkEngine::updatePacketsInTransit(QSocket& socket)
 		{
-			list<outbound_packet>::iterator packetIterator = packetsInTransit.begin();
+			outboundPacketList::iterator packetIterator = packetsInTransit.begin();
 
 			while (packetIterator != packetsInTransit.end())
 			{
@@ -260,7 +272,7 @@ namespace iosync
 
 				if (packetInTransit.time() > metrics.reliablePruneTime)
 				{
-					packetsInTransit.erase(packetIterator++);
+					packetIterator = erasePacket(packetIterator);
 
 					continue;
 				}
@@ -269,7 +281,7 @@ namespace iosync
 				{
 					packetInTransit.updateOutputSnapshot();
 
-					packetInTransit.sendTo(*this, socket, false);
+					resendPacket(socket, packetInTransit);
 				}
 
 				packetIterator++;
@@ -278,6 +290,13 @@ namespace iosync
 			return;
 		}
 
+		size_t networkEngine::resendPacket(QSocket& socket, outbound_packet& packetInTransit)
+		{
+			writeResend(socket, packetInTransit, packetInTransit.destinationCode);
+
+			return sendOutput(socket, (packetInTransit.destination.isSet()) ? packetInTransit.destination : senderAddress(socket));
+		}
+
 		packetID networkEngine::generateReliableID()
 		{
 			// Get the next ID.
@@ -290,14 +309,54 @@ namespace iosync
 			return ID;
 		}
 
-		headerInfo networkEngine::beginMessage(QSocket& socket, messageType msgType)
+		headerInfo networkEngine::beginMessage(QSocket& socket, messageType msgType, messageFraming outputFraming)
+		{
+			// Nothing has been routed in a new datagram.
+			if (socket.writeOffset == 0)
+			{
+				resetOutputRoute();
+			}
+
+			// Meta-data, and "frame" markers describe the datagram itself, so they're not routed.
+			if (msgType != MESSAGE_TYPE_META && msgType != MESSAGE_TYPE_FRAME)
+			{
+				outputMessages++;
+			}
+
+			// Identify this datagram, if we've been given an identifier.
+			messageHeader::writeDatagramMarker(socket, outputFraming, getConnectionID());
+
+			return messageHeader(msgType, 0, outputFraming).writeTo(socket);
+		}
+
+		void networkEngine::routeMessage(subscriptionChannels channels)
+		{
+			outputRoute |= channels;
+
+			routedMessages++;
+
+			return;
+		}
+
+		subscriptionChannels networkEngine::outputChannels() const
 		{
-			return messageHeader(msgType).writeTo(socket);
+			if (outputMessages == 0 || routedMessages < outputMessages)
+				return SUBSCRIPTION_CHANNELS_ALL;
+
+			return outputRoute;
 		}
 
 		void networkEngine::finishMessage(QSocket& socket, const headerInfo header_Information)
 		{
-			messageHeader::markCurrentSize(socket, header_Information.packetSize_position);
+			if (header_Information.framing == MESSAGE_FRAMING_COMPACT)
+			{
+				// Compact headers are written in front of the data-segment, so an empty footer is used.
+				messageFooter().writeTo(socket, header_Information);
+
+				return;
+			}
+
+			messageHeader::markCurrentSize(socket, header_Information.entryPoint+header_Information.packetSize_position);
 
 			return;
 		}
@@ -318,7 +377,7 @@ namespace iosync
 
 			auto footer = finishMessage(socket, header_Information, forwardAddress, identifier);
 
-			outbound_packet output((realAddress.isSet()) ? realAddress : address(socket), nullptr, identifier);
+			outbound_packet output((realAddress.isSet()) ? realAddress : senderAddress(socket), nullptr, identifier);
 			output.parodySerializedOutputMessage(socket, header_Information, footer.serializedSize, false);
 
 			return output;
@@ -340,6 +399,9 @@ namespace iosync
 			// Prepare the output-header:
 			header_out.directedHere = true;
 
+			// The message is re-serialized using our own wire-format.
+			header_out.framing = framing;
+
 			// Prepare the output-footer:
 
 			//footer_out.reliableIdentifier = footer.reliableIdentifier;
@@ -380,7 +442,7 @@ namespace iosync
 				case DESTINATION_REPLY:
 					finalizeOutput(socket, destination);
 
-					return socket.sendMsg(resetLength);
+					return sendOutput(socket, senderAddress(socket), resetLength);
 				case DESTINATION_ALL:
 				case DESTINATION_EVERYONE:
 					return broadcastMessage(socket, destination, resetLength);
@@ -408,7 +470,7 @@ namespace iosync
 		{
 			finalizeOutput(socket, destinationCode);
 
-			return (size_t)socket.sendMsg(remote.IP, remote.port, resetLength);
+			return sendOutput(socket, remote, resetLength);
 		}
 
 		size_t networkEngine::sendMessage(networkDestinationCode destination, bool resetLength)
@@ -416,6 +478,66 @@ namespace iosync
 			return sendMessage(this->socket, destination, resetLength);
 		}
 
+		size_t networkEngine::sendOutput(QSocket& socket, const address& remote, bool resetLength)
+		{
+			if (fragments.shouldFragment((size_t)socket.writeOffset))
+			{
+				return sendFragments(socket, remote, resetLength);
+			}
+
+			return sendDatagram(socket, remote, resetLength);
+		}
+
+		size_t networkEngine::sendDatagram(QSocket& socket, const address& remote, bool resetLength)
+		{
+			return (size_t)socket.sendMsg(remote.IP, remote.port, resetLength);
+		}
+
+		address networkEngine::senderAddress(const QSocket& socket) const
+		{
+			return address(socket);
+		}
+
+		size_t networkEngine::sendFragments(QSocket& socket, const address& remote, bool resetLength)
+		{
+			// Local variable(s):
+			auto datagramSize = (size_t)socket.writeOffset;
+			auto payloadSize = fragments.metrics.fragmentPayloadSize();
+
+			auto identifier = fragments.generateGroupID();
+			auto count = fragments.fragmentCount(datagramSize);
+
+			size_t bytesSent = 0;
+
+			// Copy the finalized datagram out of the output-buffer, then clear it.
+			vector<uqchar> datagram(socket.outbuffer, socket.outbuffer + datagramSize);
+
+			socket.flushOutput();
+
+			for (fragmentIndex index = 0; index < count; index++)
+			{
+				auto offset = ((size_t)index * payloadSize);
+				auto fragmentSize = min(payloadSize, (datagramSize - offset));
+
+				auto info = beginMessage(socket, MESSAGE_TYPE_FRAGMENT);
+
+				serializeFragment(socket, identifier, index, count, (fragmentLength)datagramSize, (fragmentLength)offset);
+
+				socket.UwriteBytes(datagram.data() + offset, fragmentSize);
+
+				// Each fragment is sent reliably, so lost fragments may be resent individually.
+				bytesSent += sendMessage(socket, finishReliableMessage(socket, remote, info));
+			}
+
+			// Restore the original output, if requested.
+			if (!resetLength)
+			{
+				socket.UwriteBytes(datagram.data(), datagramSize);
+			}
+
+			return bytesSent;
+		}
+
 		bool networkEngine::hasRemoteConnection() const
 		{
 			// Return the default response.
@@ -448,6 +570,12 @@ namespace iosync
 			// Add the packet specified into
 			packetsInTransit.push_back(p);
 
+			auto packetInTransit = prev(packetsInTransit.end());
+
+			packetIndex[packetInTransit->identifier] = packetInTransit;
+
+			onPacketAdded(packetInTransit);
+
 			// Return the default response.
 			return true;
 		}
@@ -459,14 +587,11 @@ namespace iosync
 
 		void networkEngine::removeReliablePacket(packetID ID)
 		{
-			for (auto& packetInTransit : packetsInTransit)
-			{
-				if (packetInTransit.identifier == ID)
-				{
-					packetsInTransit.remove(packetInTransit);
+			auto entry = packetIndex.find(ID);
 
-					break;
-				}
+			if (entry != packetIndex.end())
+			{
+				erasePacket(entry->second);
 			}
 
 			return;
@@ -474,69 +599,79 @@ namespace iosync
 
 		bool networkEngine::hasReliablePacket(packetID ID) const
 		{
-			for (auto& packetInTransit : packetsInTransit)
-			{
-				if (packetInTransit.identifier == ID)
-				{
-					return true;
-				}
-			}
-
-			// Return the default response.
-			return false;
+			return (packetIndex.find(ID) != packetIndex.end());
 		}
 
 		bool networkEngine::removeReliablePacket(const address& remoteAddress, packetID ID)
 		{
-			for (auto& packetInTransit : packetsInTransit)
+			auto entry = packetIndex.find(ID);
+
+			if (entry == packetIndex.end())
+				return false;
+
+			// Local variable(s):
+			auto packetInTransit = entry->second;
+
+			if (packetInTransit->waitingConnections.empty())
 			{
-				if (packetInTransit.identifier == ID)
-				{
-					if (packetInTransit.waitingConnections.empty())
-					{
-						removeReliablePacket(ID);
+				erasePacket(packetInTransit);
 
-						return true;
-					}
-					else
-					{
-						// Retrieve the corrisponding player-object to the 'remoteAddress' argument.
-						auto p = getPlayer(packetInTransit.waitingConnections, remoteAddress);
+				return true;
+			}
 
-						if (p != nullptr)
-						{
-							return removeReliablePacket(p, packetInTransit);
-						}
+			// Retrieve the slot of the player at 'remoteAddress'.
+			auto slot = getPlayerSlot(remoteAddress);
 
-						break;
-					}
-				}
+			if (slot != PLAYER_SLOT_NONE && packetInTransit->waitingConnections.remove(slot))
+			{
+				onPacketReleased(packetInTransit, slot);
+
+				// Check if anyone else still needs to confirm this packet:
+				if (!packetInTransit->waitingConnections.empty())
+					return false;
+
+				erasePacket(packetInTransit);
+
+				return true;
 			}
 
 			// Return the default response.
 			return false;
 		}
 
-		bool networkEngine::removeReliablePacket(player* p, outbound_packet& packetInTransit)
+		bool networkEngine::removeReliablePacket(player* p, outboundPacketList::iterator packetInTransit)
 		{
-			if (!packetInTransit.waitingConnections.empty())
+			if (!packetInTransit->waitingConnections.empty())
 			{
-				packetInTransit.waitingConnections.remove(p);
+				if (packetInTransit->waitingConnections.remove(p->slot))
+				{
+					onPacketReleased(packetInTransit, p->slot);
+				}
 
 				// Check if this container still isn't empty:
-				if (!packetInTransit.waitingConnections.empty())
+				if (!packetInTransit->waitingConnections.empty())
 				{
 					// Tell the user we aren't done yet.
 					return false;
 				}
 			}
 
-			packetsInTransit.remove(packetInTransit);
+			erasePacket(packetInTransit);
 
 			// Tell the user we found the packet, and successfully removed it.
 			return true;
 		}
 
+		playerSlot networkEngine::getPlayerSlot(const address&) const
+		{
+			return PLAYER_SLOT_NONE;
+		}
+
+		playerSlot networkEngine::getConnectionID() const
+		{
+			return PLAYER_SLOT_NONE;
+		}
+
 		size_t networkEngine::handleMessages(QSocket& socket)
 		{
 			// Local variable(s):
@@ -548,104 +683,148 @@ namespace iosync
 			// Check for incoming messages:
 			while (updateSocket(socket))
 			{
-				#ifdef QSOCK_TESTMODE
-					streamLocation initialPosition = socket.readOffset;
-				#endif
+				messages += handleDatagram(socket);
 
-				while (socket.canRead())
+				// Handle any datagrams that were reassembled from fragments:
+				while (fragments.hasCompleted())
 				{
-					// Local variable(s):
-					streamLocation startPosition = socket.readOffset;
-
-					messageHeader header;
-					messageFooter footer;
+					auto datagram = move(fragments.completed.front());
 
-					header.readFrom(socket, footer);
+					fragments.completed.pop_front();
 
-					if (header.directedHere)
+					if (fragmentManager::loadDatagram(socket, datagram))
 					{
-						if (footer.isReliable())
-						{
-							if (!onReliableMessage(socket, address(socket), header, footer))
-							{
-								// Reliable messages aren't supported, or this message
-								// has already been received, skip this message:
-								passMessage(header, footer);
-
-								// Continue to the next message.
-								continue;
-							}
-						}
+						messages += handleDatagram(socket);
+					}
+				}
 
-						// Store the current read-position.
-						auto parsePosition = socket.readOffset;
+				// Make sure we don't spend all of our time reading messages:
+				/*
+				if (elapsed(timer) > metrics.pollTimeout)
+				{
+					break;
+				}
+				*/
+			};
 
-						// Attempt to parse the message:
-						if (!parseMessage(socket, address(socket), header, footer))
-						{
-							// Move back to the beginning of the message.
-							socket.inSeek(parsePosition);
+			return messages;
+		}
 
-							// Report to the standard log.
-							clog << UNABLE_TO_PARSE_MESSAGE << header.type << endl;
+		size_t networkEngine::handleDatagram(QSocket& socket)
+		{
+			// Local variable(s):
+			size_t messages = 0;
 
-							// We were unable to parse this message, skip it:
-							passMessage(header, footer);
+			// Check which wire-format this datagram uses, and who sent it (If specified).
+			auto inputFraming = messageHeader::readDatagramFraming(socket, inputConnection);
 
-							// Continue to the next message.
-							continue;
-						}
+			// Datagrams identified as our own were relayed to a multicast group we're in; ignore them.
+			if (inputConnection != PLAYER_SLOT_NONE && inputConnection == getConnectionID())
+			{
+				inputConnection = PLAYER_SLOT_NONE;
 
-						// Add to the message-counter.
-						messages += 1;
+				return messages;
+			}
 
-						// Calculate the number of bytes read while parsing.
-						auto bytesRead = socket.readOffset-parsePosition;
+			#ifdef QSOCK_TESTMODE
+				streamLocation initialPosition = socket.readOffset;
+			#endif
 
-						if (bytesRead < header.packetSize)
-						{
-							clog << EXTRA_BYTES_DETECTED << bytesRead << "/" << header.packetSize;
-							clog << " (" << (header.packetSize-bytesRead) << " bytes left)." << endl;
+			while (socket.canRead())
+			{
+				// Local variable(s):
+				streamLocation startPosition = socket.readOffset;
 
-							//socket.inSeek(parsePosition+header.packetSize+footer.serializedSize);
+				messageHeader header;
+				messageFooter footer;
 
-							// Formally pass the message:
-							socket.inSeek(parsePosition);
+				header.readFrom(socket, footer, inputFraming);
 
+				if (header.directedHere)
+				{
+					if (footer.isReliable())
+					{
+						if (!onReliableMessage(socket, senderAddress(socket), header, footer))
+						{
+							// Reliable messages aren't supported, or this message
+							// has already been received, skip this message:
 							passMessage(header, footer);
 
 							// Continue to the next message.
 							continue;
 						}
+					}
+
+					// Store the current read-position.
+					auto parsePosition = socket.readOffset;
+
+					// Attempt to parse the message:
+					if (!parseMessage(socket, senderAddress(socket), header, footer))
+					{
+						// Move back to the beginning of the message.
+						socket.inSeek(parsePosition);
 
-						// Pass this message's footer; already read it.
-						passFooter(footer);
+						// Report to the standard log.
+						clog << UNABLE_TO_PARSE_MESSAGE << header.type << endl;
+
+						// We were unable to parse this message, skip it:
+						passMessage(header, footer);
+
+						// Continue to the next message.
+						continue;
 					}
-					else
+
+					// Add to the message-counter.
+					messages += 1;
+
+					// Check if the rest of this datagram should be ignored:
+					if (skipDatagram)
 					{
-						auto addrOfSocket = address(socket);
+						skipDatagram = false;
 
-						if (!onForwardPacket(socket, startPosition, addrOfSocket, header, footer))
-						{
-							clog << UNABLE_TO_FORWARD_PACKET << addrOfSocket << endl;
+						break;
+					}
 
-							// Packet forwarding could not be done.
-							passMessage(header, footer);
+					// Calculate the number of bytes read while parsing.
+					auto bytesRead = socket.readOffset-parsePosition;
 
-							// Continue to the next message.
-							continue;
-						}
+					if (bytesRead < header.packetSize)
+					{
+						clog << EXTRA_BYTES_DETECTED << bytesRead << "/" << header.packetSize;
+						clog << " (" << (header.packetSize-bytesRead) << " bytes left)." << endl;
+
+						//socket.inSeek(parsePosition+header.packetSize+footer.serializedSize);
+
+						// Formally pass the message:
+						socket.inSeek(parsePosition);
+
+						passMessage(header, footer);
+
+						// Continue to the next message.
+						continue;
 					}
-				}
 
-				// Make sure we don't spend all of our time reading messages:
-				/*
-				if (elapsed(timer) > metrics.pollTimeout)
+					// Pass this message's footer; already read it.
+					passFooter(footer);
+				}
+				else
 				{
-					break;
+					auto addrOfSocket = senderAddress(socket);
+
+					if (!onForwardPacket(socket, startPosition, addrOfSocket, header, footer))
+					{
+						clog << UNABLE_TO_FORWARD_PACKET << addrOfSocket << endl;
+
+						// Packet forwarding could not be done.
+						passMessage(header, footer);
+
+						// Continue to the next message.
+						continue;
+					}
 				}
-				*/
-			};
+			}
+
+			inputConnection = PLAYER_SLOT_NONE;
 
 			return messages;
 		}
@@ -662,6 +841,10 @@ namespace iosync
 				case MESSAGE_TYPE_CONFIRM_PACKET:
 					parsePacketConfirmationMessage(socket, remoteAddress, header, footer);
 
+					break;
+				case MESSAGE_TYPE_FRAGMENT:
+					parseFragment(socket, remoteAddress, header);
+
 					break;
 				case MESSAGE_TYPE_LEAVE:
 					parseLeaveNotice(socket, remoteAddress, footer.forwardAddress);
@@ -685,11 +868,19 @@ namespace iosync
 		// Nothing so far.
 
 		// Serialization related:
-		void networkEngine::serializeConnectionMessage(QSocket& socket, wstring name)
+		void networkEngine::serializeConnectionMessage(QSocket& socket, wstring name, connectionType type)
 		{
 			// Write the namne of the connecting player.
 			socket.writeWideString(name);
 
+			serializeFraming(socket);
+
+			// Players don't describe their type; this keeps us compatible with older servers.
+			if (type != CONNECTION_TYPE_PLAYER)
+			{
+				socket.write<connectionType>(type);
+			}
+
 			return;
 		}
 
@@ -707,6 +898,24 @@ namespace iosync
 			return;
 		}
 
+		void networkEngine::serializeFraming(QSocket& socket)
+		{
+			socket.write<messageFraming>(maximumFraming);
+
+			return;
+		}
+
+		void networkEngine::serializeFragment(QSocket& socket, fragmentGroupID identifier, fragmentIndex index, fragmentIndex count, fragmentLength totalSize, fragmentLength offset)
+		{
+			socket.write<fragmentGroupID>(identifier);
+			socket.write<fragmentIndex>(index);
+			socket.write<fragmentIndex>(count);
+			socket.write<fragmentLength>(totalSize);
+			socket.write<fragmentLength>(offset);
+
+			return;
+		}
+
 		// Parsing/deserialization related:
 		disconnectionReason networkEngine::parseLeaveNotice(QSocket& socket, const address& remoteAddress, const address& forwardAddress)
 		{
@@ -720,17 +929,73 @@ namespace iosync
 			// Read the identifier from the input.
 			auto ID = socket.read<packetID>();
 
-			// Remove the reliable-packet with this identifier.
-			removeReliablePacket(remoteAddress, ID);
+			// Remove the reliable-packet with this identifier; if nobody
+			// else is waiting on this packet, it's officially confirmed.
+			if (removeReliablePacket(remoteAddress, ID))
+				parentProgram.onNetworkPacketConfirmed(*this, ID);
 
 			// Return the packet-identifier.
 			return ID;
 		}
 
+		messageFraming networkEngine::parseFraming(QSocket& socket, const messageHeader& header, streamLocation parsePosition)
+		{
+			// Check if the remote connection described a wire-format:
+			if ((socket.readOffset-parsePosition) + sizeof(messageFraming) > header.packetSize)
+				return MESSAGE_FRAMING_LEGACY;
+
+			auto remoteFraming = socket.read<messageFraming>();
+
+			// Use the latest format both sides support.
+			return max<messageFraming>(MESSAGE_FRAMING_LEGACY, min(remoteFraming, maximumFraming));
+		}
+
+		connectionType networkEngine::parseConnectionType(QSocket& socket, const messageHeader& header, streamLocation parsePosition)
+		{
+			// Check if the remote connection described its type:
+			if ((socket.readOffset-parsePosition) + sizeof(connectionType) > header.packetSize)
+				return CONNECTION_TYPE_PLAYER;
+
+			return socket.read<connectionType>();
+		}
+
+		playerSlot networkEngine::parseConnectionID(QSocket& socket, const messageHeader& header, streamLocation parsePosition)
+		{
+			// Check if the remote connection described an identifier:
+			if ((socket.readOffset-parsePosition) + sizeof(playerSlot) > header.packetSize)
+				return PLAYER_SLOT_NONE;
+
+			return socket.read<playerSlot>();
+		}
+
+		bool networkEngine::parseFragment(QSocket& socket, const address& remoteAddress, const messageHeader& header)
+		{
+			// Check for errors:
+			if (header.packetSize < FRAGMENT_HEADER_SIZE)
+				return false;
+
+			// Local variable(s):
+			auto identifier = socket.read<fragmentGroupID>();
+			auto index = socket.read<fragmentIndex>();
+			auto count = socket.read<fragmentIndex>();
+			auto totalSize = socket.read<fragmentLength>();
+			auto offset = socket.read<fragmentLength>();
+
+			// The rest of the message is the fragment itself.
+			auto fragmentSize = ((size_t)header.packetSize - FRAGMENT_HEADER_SIZE);
+
+			// The fragment is copied by 'addFragment', so we can consume it afterward.
+			auto response = fragments.addFragment(remoteAddress, identifier, index, count, totalSize, offset, socket.simulatedUReadBytes(fragmentSize), fragmentSize);
+
+			socket.inSeekForward(fragmentSize);
+
+			return response;
+		}
+
 		// Methods (Protected):
 
 		// Message generation:
-		void networkEngine::finalizeOutput(QSocket& s, networkDestinationCode destinationCode)
+		void networkEngine::finalizeOutput(QSocket& s, networkDestinationCode destinationCode, messageFraming outputFraming)
 		{
 			// Check if we're a client:
 			//if (!isHostNode)
@@ -738,7 +1003,7 @@ namespace iosync
 				// Create a final message:
 
 				// Start a new message.
-				auto headerInformation = beginMessage(s, MESSAGE_TYPE_META);
+				auto headerInformation = beginMessage(s, MESSAGE_TYPE_META, outputFraming);
 
 				// Serialize the destination-code.
 				s << destinationCode;
@@ -750,29 +1015,90 @@ namespace iosync
 			return;
 		}
 
+		// Reliable packet related:
+		void networkEngine::writeResend(QSocket& socket, outbound_packet& packetInTransit, networkDestinationCode destinationCode)
+		{
+			// Stored packets aren't sent alongside anything else, so they're read back in one wire-format.
+			socket.flushOutput();
+
+			packetInTransit.writeTo(socket, false);
+
+			finalizeOutput(socket, destinationCode, packetInTransit.framing);
+
+			return;
+		}
+
 		// Parsing/deserialization related:
 		networkDestinationCode networkEngine::parseMeta(QSocket& socket, const address& remoteAddress, const messageHeader& header)
 		{
 			return socket.read<networkDestinationCode>();
 		}
 
-		// clientNetworkEngine:
+		subscriptionChannels networkEngine::parseMessageChannels(QSocket& socket, const messageHeader& header)
+		{
+			// Our own messages aren't routed.
+			if (header.type < MESSAGE_TYPE_CUSTOM_LOCATION)
+				return SUBSCRIPTION_CHANNELS_ALL;
 
-		// Constructor(s):
-		clientNetworkEngine::clientNetworkEngine(application& parent, wstring username, networkMetrics metrics)
-			: connection(), networkEngine(parent, metrics), connected(false)
+			// Local variable(s):
+			auto position = socket.readOffset;
+
+			auto channels = parentProgram.getNetworkMessageChannels(socket, header);
+
+			// Seek back to the beginning of the message.
+			socket.inSeek(position);
+
+			return channels;
+		}
+
+		// Reliable packet related:
+		void networkEngine::onPacketAdded(outboundPacketList::iterator)
 		{
-			// Set the name of this connection.
-			connection.name = username;
+			return;
 		}
 
-		bool clientNetworkEngine::open(string remoteAddress, addressPort remotePort, addressPort localPort)
+		void networkEngine::onPacketRemoved(outboundPacketList::iterator)
 		{
-			if (!networkEngine::open())
-				return false;
+			return;
+		}
 
-			if (!socket.connect(remoteAddress, remotePort, localPort))
-				return false;
+		void networkEngine::onPacketReleased(outboundPacketList::iterator, playerSlot)
+		{
+			return;
+		}
+
+		outboundPacketList::iterator networkEngine::erasePacket(outboundPacketList::iterator packetInTransit)
+		{
+			onPacketRemoved(packetInTransit);
+
+			// Identifiers may be reused once they wrap; only forget the entry if it still refers to this packet.
+			auto entry = packetIndex.find(packetInTransit->identifier);
+
+			if (entry != packetIndex.end() && entry->second == packetInTransit)
+			{
+				packetIndex.erase(entry);
+			}
+
+			return packetsInTransit.erase(packetInTransit);
+		}
+
+		// clientNetworkEngine:
+
+		// Constructor(s):
+		clientNetworkEngine::clientNetworkEngine(application& parent, wstring username, networkMetrics metrics)
+			: connection(), networkEngine(parent, metrics), connected(false)
+		{
+			// Set the name of this connection.
+			connection.name = username;
+		}
+
+		bool clientNetworkEngine::open(string remoteAddress, addressPort remotePort, addressPort localPort)
+		{
+			if (!networkEngine::open())
+				return false;
+
+			if (!socket.connect(remoteAddress, remotePort, localPort))
+				return false;
 
 			master.IP = basic_socket::nonNativeToNativeIP(remoteAddress);
 			master.port = remotePort;
@@ -794,6 +1120,17 @@ namespace iosync
 		{
 			this->connected = false;
 
+			// The next connection will be assigned a new identifier.
+			connection.slot = PLAYER_SLOT_NONE;
+
+			// The next connection will need to announce its multicast group.
+			multicast.leave();
+
+			multicastConfirmed = false;
+
+			// Frames from the next server are numbered separately.
+			receivedFrame = false;
+
 			// Return the super-class's response.
 			return networkEngine::close();
 		}
@@ -803,6 +1140,30 @@ namespace iosync
 		// Update routines:
 		void clientNetworkEngine::update()
 		{
+			// Check if we were redirected to a relay "node":
+			if (redirection.isSet())
+			{
+				// Local variable(s):
+				auto origin = master;
+				auto node = redirection;
+
+				redirection = address();
+
+				clog << "Redirected to relay node: " << node << endl;
+
+				close();
+
+				if (!open(QSocket::representIP(node.IP), node.port))
+				{
+					throw exceptions::networkClosed(*this);
+
+					return;
+				}
+
+				// The server that redirected us is still the origin of this session.
+				master = origin;
+			}
+
 			// Check if we've timed-out:
 			if (timedOut())
 			{
@@ -814,6 +1175,8 @@ namespace iosync
 			// Call the super-class's implementation.
 			networkEngine::update();
 
+			handleMulticast(socket);
+
 			return;
 		}
 
@@ -836,6 +1199,18 @@ namespace iosync
 			return;
 		}
 
+		size_t clientNetworkEngine::resendPacket(QSocket& socket, outbound_packet& packetInTransit)
+		{
+			if (packetInTransit.destinationCode == DESTINATION_DIRECT)
+			{
+				return networkEngine::resendPacket(socket, packetInTransit);
+			}
+
+			writeResend(socket, packetInTransit, packetInTransit.destinationCode);
+
+			return sendOutput(socket, connection.remoteAddress);
+		}
+
 		bool clientNetworkEngine::onForwardPacket(QSocket& socket, streamLocation startPosition, const address& remoteAddress, const messageHeader& header, const messageFooter& footer)
 		{
 			// Re-write the message.
@@ -889,6 +1264,16 @@ namespace iosync
 			switch (header.type)
 			{
 				case MESSAGE_TYPE_JOIN:
+				{
+					// Local variable(s):
+					auto parsePosition = socket.readOffset;
+
+					// Use the wire-format the server agreed to.
+					framing = parseFraming(socket, header, parsePosition);
+
+					// Use the identifier the server assigned us, if any.
+					connection.slot = parseConnectionID(socket, header, parsePosition);
+
 					if (!connected)
 					{
 						// Set the connection-flag.
@@ -896,10 +1281,80 @@ namespace iosync
 
 						updateSnapshot();
 
+						// Tell the server what we're subscribed to, if we've narrowed it down.
+						if (connection.subscriptions != SUBSCRIPTION_CHANNELS_ALL)
+						{
+							subscribe(socket, connection.subscriptions);
+						}
+
 						parentProgram.onNetworkConnected(*this);
 					}
 
 					break;
+				}
+				case MESSAGE_TYPE_REDIRECT:
+				{
+					// Local variable(s):
+					address node;
+
+					node.readFrom(socket);
+
+					// Only the server we're joining may redirect us.
+					if (!connected && remoteAddress == connection.remoteAddress)
+					{
+						redirection = node;
+					}
+
+					break;
+				}
+				case MESSAGE_TYPE_FRAME:
+				{
+					// Local variable(s):
+					auto frame = socket.read<frameNumber>();
+
+					// Frames that arrive after a later frame are out of date; ignore the rest of this datagram.
+					if (receivedFrame && (int)(frame - lastFrame) <= 0)
+					{
+						skipDatagram = true;
+
+						break;
+					}
+
+					lastFrame = frame;
+					receivedFrame = true;
+
+					break;
+				}
+				case MESSAGE_TYPE_MULTICAST:
+				{
+					// Local variable(s):
+					address group;
+
+					group.readFrom(socket);
+
+					if (receivingMulticast)
+					{
+						// The server's group reaches us; tell the server, so it stops sending to us directly.
+						if (!multicastConfirmed)
+						{
+							networkEngine::sendMessage(socket, generateMulticastMessage(socket, group), DESTINATION_HOST);
+
+							multicastConfirmed = true;
+						}
+					}
+					else if (!multicast.joined() || multicast.group != group)
+					{
+						// The server announced its group; join it, then wait for it to reach us.
+						if (!multicast.join(group))
+						{
+							clog << "Unable to join multicast group: " << group << endl;
+						}
+
+						multicastConfirmed = false;
+					}
+
+					break;
+				}
 				case MESSAGE_TYPE_PING:
 					// Update the connection-time snapshot.
 					updateSnapshot();
@@ -978,6 +1433,23 @@ namespace iosync
 			return &connection;
 		}
 
+		playerSlot clientNetworkEngine::getConnectionID() const
+		{
+			return connection.slot;
+		}
+
+		void clientNetworkEngine::subscribe(QSocket& socket, subscriptionChannels channels)
+		{
+			connection.subscriptions = channels;
+
+			if (connected)
+			{
+				networkEngine::sendMessage(socket, generateSubscriptionMessage(socket, channels), DESTINATION_HOST);
+			}
+
+			return;
+		}
+
 		bool clientNetworkEngine::alone() const
 		{
 			return !connected;
@@ -989,6 +1461,34 @@ namespace iosync
 		}
 
 		// Methods (Protected):
+		size_t clientNetworkEngine::handleMulticast(QSocket& socket)
+		{
+			// Local variable(s):
+			size_t messages = 0;
+
+			address sender;
+
+			receivingMulticast = true;
+
+			/*
+				Datagrams are loaded into the input-buffer of 'socket', so the address of the
+				last datagram 'socket' received is used while handling them. This is always our server.
+			*/
+
+			while (multicast.receive(socket, sender))
+			{
+				// Only accept datagrams from our server.
+				if (sender == connection.remoteAddress)
+				{
+					messages += handleDatagram(socket);
+				}
+			}
+
+			receivingMulticast = false;
+
+			return messages;
+		}
+
 		/*
 		networkDestinationCode clientNetworkEngine::parseMeta(QSocket& socket, const address& remoteAddress, const messageHeader& header)
 		{
@@ -1005,6 +1505,13 @@ namespace iosync
 
 		// serverNetworkEngine:
 
+		// Structures:
+
+		// playerTimer:
+
+		// Constructor(s):
+		serverNetworkEngine::playerTimer::playerTimer(high_resolution_clock::time_point deadline, playerSlot slot) : deadline(deadline), slot(slot) { /* Nothing so far. */ }
+
 		// Constructor(s):
 		serverNetworkEngine::serverNetworkEngine(application& parent, networkMetrics metrics)
 			: networkEngine(parent, metrics) { isHostNode = true; isMaster = true; }
@@ -1038,6 +1545,9 @@ namespace iosync
 			// Call the super-class's implementation.
 			networkEngine::update();
 
+			// Send everything aggregated while handling messages.
+			sendFrame(socket);
+
 			checkClientTimeouts();
 
 			return;
@@ -1061,29 +1571,131 @@ namespace iosync
 		void serverNetworkEngine::checkClientTimeouts(QSocket& socket)
 		{
 			// Local variable(s):
-			auto p = players.begin();
+			auto now = high_resolution_clock::now();
 
-			while (p != players.end())
+			while (!timers.empty() && timers.top().deadline <= now)
 			{
-				if (timedOut(*p))
-				{
-					parentProgram.onNetworkClientTimedOut(*this, **p);
+				auto timer = timers.top();
+
+				timers.pop();
 
-					forceDisconnectPlayer(socket, *p, DISCONNECTION_REASON_TIMEDOUT, false, false);
+				auto p = registry.at(timer.slot);
+
+				// Skip timers left behind by removed players, or replaced since.
+				if (p == nullptr || p->timerDeadline != timer.deadline)
+					continue;
+
+				if (timedOut(p))
+				{
+					parentProgram.onNetworkClientTimedOut(*this, *p);
 
-					// Remove the invalid "reference" from the 'players' container.
-					players.erase(p++);
+					forceDisconnectPlayer(socket, p, DISCONNECTION_REASON_TIMEDOUT, false);
 
 					continue;
 				}
 
-				p++;
+				// Check if this player is due to be pinged:
+				if (!p->pinging && p->connectionTime() >= metrics.pingInterval)
+				{
+					// Send a message to this player.
+					sendMessage(socket, generatePingMessage(socket, p, p->vaddr()));
+
+					// Update this player's connection-snapshot.
+					p->updateSnapshot();
+
+					// Set this player as "pinging", so we don't send incorrectly.
+					p->pinging = true;
+				}
+
+				// This player may have been heard from since this timer was queued.
+				scheduleTimer(p);
 			}
 
 			return;
 		}
 
-		size_t serverNetworkEngine::broadcastMessage(QSocket& socket, playerList players, networkDestinationCode destinationCode, bool resetLength)
+		size_t serverNetworkEngine::resendPacket(QSocket& socket, outbound_packet& packetInTransit)
+		{
+			// Local variable(s):
+			bool broadcast = (packetInTransit.destinationCode == DESTINATION_ALL || packetInTransit.destinationCode == DESTINATION_EVERYONE);
+
+			if (packetInTransit.waitingConnections.empty() && !broadcast)
+			{
+				return networkEngine::resendPacket(socket, packetInTransit);
+			}
+
+			size_t sent = 0;
+
+			writeResend(socket, packetInTransit, DEFAULT_DESTINATION);
+
+			if (packetInTransit.waitingConnections.empty())
+			{
+				// Broadcasts without a list of recipients are re-sent to everyone.
+				for (auto p : players)
+				{
+					sent += sendOutput(socket, p->remoteAddress, false);
+				}
+			}
+			else
+			{
+				// Only send to those who haven't confirmed this packet:
+				packetInTransit.waitingConnections.forEach
+				(
+					[this, &socket, &sent] (playerSlot slot)
+					{
+						auto p = registry.at(slot);
+
+						if (p != nullptr)
+						{
+							sent += sendOutput(socket, p->remoteAddress, false);
+						}
+
+						return;
+					}
+				);
+			}
+
+			socket.flushOutput();
+
+			return sent;
+		}
+
+		playerSlot serverNetworkEngine::getPlayerSlot(const address& remoteAddress) const
+		{
+			auto p = getPlayer(remoteAddress);
+
+			if (p == nullptr)
+				return PLAYER_SLOT_NONE;
+
+			return p->slot;
+		}
+
+		recipientSet serverNetworkEngine::subscribers(subscriptionChannels channels, const player* excluded) const
+		{
+			// Unrouted messages are sent to everyone.
+			if (channels == SUBSCRIPTION_CHANNELS_ALL)
+				return recipients(excluded);
+
+			// Local variable(s):
+			recipientSet output;
+
+			for (auto p : players)
+			{
+				if (p != excluded && p->slot != PLAYER_SLOT_NONE && p->subscribedTo(channels))
+				{
+					output.add(p->slot);
+				}
+			}
+
+			return output;
+		}
+
+		size_t serverNetworkEngine::broadcastMessage(QSocket& socket, const playerList& players, networkDestinationCode destinationCode, bool resetLength)
+		{
+			return broadcastMessage(socket, players, nullptr, destinationCode, resetLength);
+		}
+
+		size_t serverNetworkEngine::broadcastMessage(QSocket& socket, const playerList& players, const player* excluded, networkDestinationCode destinationCode, bool resetLength)
 		{
 			//return socket.broadcastMsg();
 
@@ -1092,9 +1704,18 @@ namespace iosync
 			
 			size_t sent = 0;
 
+			// Only players subscribed to the channels of this datagram are sent it.
+			auto channels = outputChannels();
+
+			// Players that receive our multicast group are sent this datagram once:
+			bool multicastSent = sendMulticast(socket, excluded, channels, sent);
+
 			for (auto p : players)
 			{
-				 sent += networkEngine::sendMessage(socket, p->remoteAddress, false);
+				if (p == excluded || !p->subscribedTo(channels) || (multicastSent && p->multicastMember))
+					continue;
+
+				sent += sendOutput(socket, p->remoteAddress, false);
 			}
 
 			/*
@@ -1131,7 +1752,7 @@ namespace iosync
 
 		player* serverNetworkEngine::getPlayer(QSocket& socket)
 		{
-			return getPlayer(address(socket));
+			return getPlayer(senderAddress(socket));
 		}
 
 		bool serverNetworkEngine::alone() const
@@ -1175,21 +1796,10 @@ namespace iosync
 		// Simple messages:
 		void serverNetworkEngine::pingRemoteConnection(QSocket& socket)
 		{
-			// Send "ping" messages to every player:
-			for (auto p : players)
-			{
-				if (!p->pinging)
-				{
-					// Send a message to this player.
-					sendMessage(socket, generatePingMessage(socket, p, p->vaddr()));
-
-					// Update this player's connection-snapshot.
-					p->updateSnapshot();
+			// Let players check that our multicast group reaches them.
+			sendMulticastProbe(socket);
 
-					// Set this player as "pinging", so we don't send incorrectly.
-					p->pinging = true;
-				}
-			}
+			// Players are pinged on their own schedules; see 'checkClientTimeouts'.
 
 			return;
 		}
@@ -1204,8 +1814,8 @@ namespace iosync
 		{
 			if (packet.destinationCode == DESTINATION_ALL || packet.destinationCode == DESTINATION_EVERYONE)
 			{
-				// Make a copy of the current player-list.
-				packet.waitingConnections = players;
+				// Every player this packet is routed to needs to confirm it.
+				packet.waitingConnections = subscribers((alreadyInOutput) ? outputChannels() : SUBSCRIPTION_CHANNELS_ALL);
 			}
 
 			return networkEngine::sendMessage(socket, packet, alreadyInOutput);
@@ -1256,6 +1866,9 @@ namespace iosync
 
 					p->pinging = false;
 
+					// Move this player's next ping back, now that we've heard from them.
+					scheduleTimer(p);
+
 					break;
 				case MESSAGE_TYPE_PONG:
 					// Set this player's ping to the number
@@ -1267,7 +1880,51 @@ namespace iosync
 
 					p->pinging = false;
 
+					// Replace the time-out queued with our ping, so this player is pinged again on schedule.
+					scheduleTimer(p);
+
+					break;
+				case MESSAGE_TYPE_MULTICAST:
+				{
+					// Local variable(s):
+					address group;
+
+					group.readFrom(socket);
+
+					// This player receives our multicast group; stop sending to them directly.
+					p->multicastMember = (multicastGroup.isSet() && group == multicastGroup);
+
+					break;
+				}
+				case MESSAGE_TYPE_SUBSCRIBE:
+					// From now on, only route messages on these channels to this player.
+					p->subscriptions = socket.read<subscriptionChannels>();
+
+					break;
+				case MESSAGE_TYPE_FRAME:
+					// "Frames" aggregated by our parent are handled like any other datagram.
+					socket.read<frameNumber>();
+
 					break;
+				case MESSAGE_TYPE_JOIN:
+					// Check if our parent accepted us as a "node":
+					if (p == parent)
+					{
+						// Local variable(s):
+						auto parsePosition = socket.readOffset;
+
+						// Use the wire-format our parent agreed to.
+						p->framing = parseFraming(socket, header, parsePosition);
+
+						// Nodes don't identify their datagrams, so the identifier is skipped.
+						parseConnectionID(socket, header, parsePosition);
+
+						updateFraming();
+
+						break;
+					}
+
+					// Let the 'program' object handle this message.
 				default:
 					// Call the 'program' object's implementation.
 					auto programResponse = parentProgram.parseNetworkMessage(socket, header, footer);
@@ -1285,16 +1942,37 @@ namespace iosync
 		bool serverNetworkEngine::parseConnectionMessage(QSocket& socket, const address& remoteAddress, const messageHeader& header, const messageFooter& footer)
 		{
 			// Local variable(s):
+			auto parsePosition = socket.readOffset;
+
 			player* p;
 
 			bool response;
 			connectionType type;
 
-			type = CONNECTION_TYPE_PLAYER; // socket.read<connectionType>();
+			// Read the player's name, and the latest wire-format this player supports.
+			auto name = socket.readWideString();
+			auto remoteFraming = parseFraming(socket, header, parsePosition);
+
+			// Relay "nodes" describe themselves after their wire-format.
+			type = parseConnectionType(socket, header, parsePosition);
 
 			switch (type)
 			{
 				case CONNECTION_TYPE_PLAYER:
+				case CONNECTION_TYPE_NODE:
+					// Check if this player should join one of our "nodes" instead:
+					if (type == CONNECTION_TYPE_PLAYER && remoteAddress == senderAddress(socket) && maximumDirectPlayers > 0 && directPlayers() >= maximumDirectPlayers)
+					{
+						auto node = getRedirectionNode();
+
+						if (node != nullptr)
+						{
+							sendRedirect(socket, remoteAddress, node);
+
+							return false;
+						}
+					}
+
 					if (remoteAddress != socket)
 					{
 						p = new indirect_player(remoteAddress, footer.forwardAddress);
@@ -1322,8 +2000,17 @@ namespace iosync
 						}
 					}
 
-					// Read the player's name from the input.
-					p->name = socket.readWideString();
+					p->name = name;
+					p->framing = remoteFraming;
+					p->isNode = (type == CONNECTION_TYPE_NODE);
+
+					updateFraming();
+
+					// "Nodes" relay for us, and indirect players are out of reach; only direct players may use multicast.
+					if (!p->isNode && !p->hasVirtualAddress())
+					{
+						announceMulticast(socket, p);
+					}
 
 					//wclog << L"Player connected: " << p->name << endl;
 
@@ -1359,15 +2046,74 @@ namespace iosync
 			return reason;
 		}
 
-		bool serverNetworkEngine::connectPlayer(QSocket& socket, player* p)
+		bool serverNetworkEngine::joinParent(QSocket& socket, const address& parentAddress, const wstring& name)
 		{
-			// Add the player to the internal-container.
-			addPlayer(p);
+			// Check for errors:
+			if (parent != nullptr || !parentAddress.isSet())
+				return false;
 
-			networkEngine::sendMessage(socket, generatePlayerConfirmationMessage(socket, p, p->vaddr()));
+			// Our parent is treated as a player, so broadcasts reach it like any other.
+			parent = new player(parentAddress);
 
-			// Return the default response.
-			return true;
+			parent->isNode = true;
+
+			addPlayer(parent);
+
+			networkEngine::sendMessage(socket, generateConnectionMessage(socket, name, parentAddress, address(), CONNECTION_TYPE_NODE));
+
+			// Return the default response.
+			return true;
+		}
+
+		size_t serverNetworkEngine::directPlayers() const
+		{
+			// Local variable(s):
+			size_t count = 0;
+
+			for (auto p : players)
+			{
+				if (!p->isNode && !p->hasVirtualAddress())
+				{
+					count++;
+				}
+			}
+
+			return count;
+		}
+
+		player* serverNetworkEngine::getRedirectionNode() const
+		{
+			// Local variable(s):
+			player* output = nullptr;
+
+			// Spread new players across our "nodes"; our parent isn't one of them.
+			for (auto p : players)
+			{
+				if (p->isNode && p != parent && (output == nullptr || p->redirectedPlayers < output->redirectedPlayers))
+				{
+					output = p;
+				}
+			}
+
+			return output;
+		}
+
+		bool serverNetworkEngine::connectPlayer(QSocket& socket, player* p)
+		{
+			// The aggregated frame may use a format this player doesn't understand; send it to everyone else first.
+			sendFrame(socket);
+
+			// Add the player to the internal-container.
+			addPlayer(p);
+
+			// New players use the legacy format until they've described what they support.
+			updateFraming();
+
+			// Direct connections are given their slot, so their datagrams can be matched without a look-up.
+			networkEngine::sendMessage(socket, generatePlayerConfirmationMessage(socket, p, p->vaddr(), ((p->hasVirtualAddress()) ? (playerSlot)PLAYER_SLOT_NONE : p->slot)));
+
+			// Return the default response.
+			return true;
 		}
 
 		bool serverNetworkEngine::disconnectPlayer(QSocket& socket, player* p, disconnectionReason reason)
@@ -1401,37 +2147,81 @@ namespace iosync
 
 		void serverNetworkEngine::onPlayerRemoved(player* p)
 		{
-			// Remove any references to this 'player':
+			// Local variable(s):
 
-			// Check for lingering packets sent directly to 'p':
-			if (getPlayer(p->remoteAddress) == nullptr)
+			// Packets sent directly to 'p', which may still be meant for another player at its address.
+			vector<outboundPacketList::iterator> directPackets;
+
+			// Remove any references to this 'player'; only the packets listed under it are visited:
+			while (!p->packetsInFlight.empty())
 			{
-				auto op = packetsInTransit.begin();
+				auto packetInTransit = p->packetsInFlight.back();
+
+				unlinkPacket(p, packetInTransit);
 
-				while (op != packetsInTransit.end())
+				if (packetInTransit->waitingConnections.empty())
 				{
-					if ((*op).isSendingTo(p))
-					{
-						packetsInTransit.erase(op++);
+					directPackets.push_back(packetInTransit);
 
-						continue;
-					}
+					continue;
+				}
 
-					op++;
+				// Remove multi-destination ties to this 'player' object:
+				if (packetInTransit->waitingConnections.remove(p->slot) && packetInTransit->waitingConnections.empty())
+				{
+					erasePacket(packetInTransit);
 				}
 			}
 
-			if (!packetsInTransit.empty())
+			// Free this player's slot, so it may be reused.
+			registry.remove(p);
+
+			// If we lost our parent, we're now the root of our own session.
+			if (p == parent)
 			{
-				auto packetInTransit = packetsInTransit.begin();
+				parent = nullptr;
+			}
 
-				// Remove multi-destination ties to this 'player' object:
-				while (packetInTransit != packetsInTransit.end())
+			// Check for lingering packets sent directly to 'p':
+			if (!directPackets.empty())
+			{
+				auto sharedAddress = getPlayer(p->remoteAddress);
+
+				for (auto packetInTransit : directPackets)
 				{
-					removeReliablePacket(p, *packetInTransit++);
+					if (sharedAddress != nullptr)
+						linkPacket(sharedAddress, packetInTransit);
+					else
+						erasePacket(packetInTransit);
 				}
 			}
 
+			// Discard any datagrams this 'player' was in the middle of sending.
+			fragments.removeConnection(p->remoteAddress);
+
+			updateFraming();
+
+			return;
+		}
+
+		void serverNetworkEngine::updateFraming()
+		{
+			// Local variable(s):
+			auto output = maximumFraming;
+
+			for (auto p : players)
+			{
+				output = min(output, p->framing);
+			}
+
+			if (output == framing)
+				return;
+
+			// The aggregated frame was written in the current format; send it before that changes.
+			sendFrame(socket);
+
+			framing = output;
+
 			return;
 		}
 
@@ -1459,6 +2249,263 @@ namespace iosync
 		}
 
 		// Methods (Protected):
+		void serverNetworkEngine::scheduleTimer(player* p)
+		{
+			// Waiting players are only checked for a time-out; everyone else is also pinged.
+			auto delay = (p->pinging) ? metrics.connectionTimeout : min(metrics.pingInterval, metrics.connectionTimeout);
+
+			p->timerDeadline = (p->connectionSnapshot + delay);
+
+			timers.push(playerTimer(p->timerDeadline, p->slot));
+
+			return;
+		}
+
+		void serverNetworkEngine::onPacketAdded(outboundPacketList::iterator packetInTransit)
+		{
+			if (!packetInTransit->waitingConnections.empty())
+			{
+				packetInTransit->waitingConnections.forEach
+				(
+					[this, packetInTransit] (playerSlot slot)
+					{
+						auto p = registry.at(slot);
+
+						if (p != nullptr)
+						{
+							linkPacket(p, packetInTransit);
+						}
+					}
+				);
+			}
+			else if (packetInTransit->destinationCode == DESTINATION_DIRECT)
+			{
+				auto p = getPlayer(packetInTransit->destination);
+
+				if (p != nullptr)
+				{
+					linkPacket(p, packetInTransit);
+				}
+			}
+
+			return;
+		}
+
+		void serverNetworkEngine::onPacketRemoved(outboundPacketList::iterator packetInTransit)
+		{
+			while (!packetInTransit->links.empty())
+			{
+				auto p = registry.at(packetInTransit->links.back().slot);
+
+				if (p == nullptr)
+				{
+					packetInTransit->links.pop_back();
+
+					continue;
+				}
+
+				unlinkPacket(p, packetInTransit);
+			}
+
+			return;
+		}
+
+		void serverNetworkEngine::onPacketReleased(outboundPacketList::iterator packetInTransit, playerSlot slot)
+		{
+			auto p = registry.at(slot);
+
+			if (p != nullptr)
+			{
+				unlinkPacket(p, packetInTransit);
+			}
+
+			return;
+		}
+
+		void serverNetworkEngine::linkPacket(player* p, outboundPacketList::iterator packetInTransit)
+		{
+			packetLink link;
+
+			link.slot = p->slot;
+			link.position = p->packetsInFlight.size();
+
+			packetInTransit->links.push_back(link);
+
+			p->packetsInFlight.push_back(packetInTransit);
+
+			return;
+		}
+
+		void serverNetworkEngine::unlinkPacket(player* p, outboundPacketList::iterator packetInTransit)
+		{
+			auto& links = packetInTransit->links;
+
+			for (size_t i = 0; i < links.size(); i++)
+			{
+				if (links[i].slot != p->slot)
+					continue;
+
+				auto position = links[i].position;
+
+				// Move the last packet listed under 'p' into this position:
+				auto moved = p->packetsInFlight.back();
+
+				p->packetsInFlight[position] = moved;
+				p->packetsInFlight.pop_back();
+
+				if (moved != packetInTransit)
+				{
+					for (auto& movedLink : moved->links)
+					{
+						if (movedLink.slot == p->slot)
+						{
+							movedLink.position = position;
+
+							break;
+						}
+					}
+				}
+
+				// Remove this link from the packet.
+				links[i] = links.back();
+				links.pop_back();
+
+				break;
+			}
+
+			return;
+		}
+
+		size_t serverNetworkEngine::sendFrame(QSocket& socket)
+		{
+			if (frameOutput.empty())
+				return 0;
+
+			// Local variable(s):
+			auto info = beginMessage(socket, MESSAGE_TYPE_FRAME);
+
+			socket.write<frameNumber>(nextFrame++);
+
+			finishMessage(socket, info);
+
+			// Add the aggregated messages, as they were relayed.
+			socket.UwriteBytes(frameOutput.data(), frameOutput.size());
+
+			outputMessages += frameMessages;
+			routedMessages += frameRoutedMessages;
+			outputRoute |= frameRoute;
+
+			frameOutput.clear();
+
+			frameMessages = 0;
+			frameRoutedMessages = 0;
+			frameRoute = 0;
+
+			// Send the frame to everyone; its senders expect to see their own input in it.
+			return networkEngine::sendMessage(socket, DESTINATION_EVERYONE, true);
+		}
+
+		void serverNetworkEngine::announceMulticast(QSocket& socket, player* p)
+		{
+			if (multicastGroup.isSet())
+			{
+				sendMessage(socket, generateMulticastMessage(socket, multicastGroup, p->remoteAddress), p);
+			}
+
+			return;
+		}
+
+		void serverNetworkEngine::sendMulticastProbe(QSocket& socket)
+		{
+			if (!multicastGroup.isSet())
+				return;
+
+			// Local variable(s):
+			auto group = multicastGroup;
+
+			auto info = beginMessage(socket, MESSAGE_TYPE_MULTICAST);
+
+			group.writeTo(socket);
+
+			finishMessage(socket, info);
+
+			networkEngine::sendMessage(socket, multicastGroup);
+
+			return;
+		}
+
+		bool serverNetworkEngine::sendMulticast(QSocket& socket, const player* excluded, subscriptionChannels channels, size_t& sent_out)
+		{
+			// Check for errors:
+			if (!multicastGroup.isSet() || fragments.shouldFragment((size_t)socket.writeOffset))
+				return false;
+
+			// Local variable(s):
+			bool members = false;
+
+			for (auto p : players)
+			{
+				if (p != excluded && p->multicastMember && p->subscribedTo(channels))
+				{
+					members = true;
+
+					break;
+				}
+			}
+
+			if (!members)
+				return false;
+
+			if (excluded == nullptr || !excluded->multicastMember)
+			{
+				sent_out += sendDatagram(socket, multicastGroup, false);
+
+				return true;
+			}
+
+			/*
+				The player this datagram is being relayed from is in our group.
+				To let them ignore their own datagram, it's identified as theirs.
+				This is only possible with compact datagrams.
+			*/
+
+			if (framing != MESSAGE_FRAMING_COMPACT || excluded->slot == PLAYER_SLOT_NONE || socket.writeOffset < (streamLocation)sizeof(messageType))
+				return false;
+
+			// Local variable(s):
+			vector<uqchar> datagram(socket.outbuffer, socket.outbuffer + socket.writeOffset);
+
+			socket.flushOutput();
+
+			messageHeader::writeDatagramMarker(socket, framing, excluded->slot);
+
+			// Copy everything after the original marker.
+			socket.UwriteBytes(datagram.data() + sizeof(messageType), datagram.size() - sizeof(messageType));
+
+			sent_out += sendDatagram(socket, multicastGroup, true);
+
+			// Restore the original datagram for everyone else.
+			socket.UwriteBytes(datagram.data(), datagram.size());
+
+			return true;
+		}
+
+		void serverNetworkEngine::sendRedirect(QSocket& socket, const address& remoteAddress, player* node)
+		{
+			// Local variable(s):
+			auto nodeAddress = node->remoteAddress;
+
+			auto info = beginMessage(socket, MESSAGE_TYPE_REDIRECT);
+
+			nodeAddress.writeTo(socket);
+
+			networkEngine::sendMessage(socket, finishReliableMessage(socket, remoteAddress, info));
+
+			node->redirectedPlayers++;
+
+			return;
+		}
+
 		networkDestinationCode serverNetworkEngine::parseMeta(QSocket& socket, const address& remoteAddress, const messageHeader& header)
 		{
 			// Call the super-class's implementation.
@@ -1468,119 +2515,26 @@ namespace iosync
 			{
 				case DESTINATION_ALL:
 				case DESTINATION_EVERYONE:
-					if (!players.empty())
-					{
-						// Local variable(s):
-						
-						// Copy the contents of the 'players' container:
-						playerList playerMask;
-
-						if (destinationCode != DESTINATION_EVERYONE)
-						{
-							playerMask = players;
+				{
+					// Local variable(s):
 
-							auto p = networkEngine::getPlayer(playerMask, socket);
+					// The player that sent this datagram.
+					player* source = getPlayer(remoteAddress);
 
-							// Remove the caller from this new container.
-							playerMask.remove(p);
-						}
+					/*
+						"Nodes" have already echoed 'DESTINATION_EVERYONE' messages back to the original sender,
+						so we only relay them to everyone else. Relaying back to a "node" would loop.
+					*/
 
-						if (!playerMask.empty() || destinationCode == DESTINATION_EVERYONE)
-						{
-							auto returnPoint = socket.readOffset;
-
-							// Seek back to the beginning.
-							socket.resetRead();
-
-							while (socket.canRead())
-							{
-								// Local variable(s):
-								streamLocation startPosition = socket.readOffset;
-
-								messageHeader header;
-								messageFooter footer;
-
-								header.readFrom(socket, footer);
-
-								if (header.directedHere)
-								{
-									switch (header.type)
-									{
-										case MESSAGE_TYPE_META:
-											// Skip this message; meta-data, same as this.
-											socket.inSeekForward(header.packetSize);
-
-											break;
-										default:
-											// Store the current read-position.
-											auto parsePosition = socket.readOffset;
-
-											// Start a new message:
-											auto headerInformation = beginMessage(socket, header.type);
-
-											// Write the bytes of this message into the output.
-											socket.UwriteBytes(socket.simulatedUReadBytes(header.packetSize), header.packetSize);
-
-											// Finish the message:
-											if (!footer.isReliable())
-											{
-												finishMessage(socket, headerInformation);
-											}
-											else
-											{
-												auto p = finishReliableMessage(socket, address(), headerInformation);
-									
-												p.destinationCode = destinationCode;
-												
-												switch (destinationCode)
-												{
-													case DESTINATION_EVERYONE:
-														p.waitingConnections = players;
-
-														break;
-													default:
-														// Copy the generated container.
-														p.waitingConnections = playerMask;
-
-														break;
-												}
-
-												// Add the new packet to the internal container.
-												addReliablePacket(p);
-											}
-
-											break;
-									}
-
-									// Pass this message's footer; already read it.
-									passFooter(footer);
-								}
-								else
-								{
-									// Packet forwarding should not be done here.
-									passMessage(header, footer);
-
-									// Continue to the next message.
-									continue;
-								}
-							}
-
-							// Send out the message:
-							switch (destinationCode)
-							{
-								case DESTINATION_EVERYONE:
-									networkEngine::sendMessage(destinationCode, true); // DESTINATION_ALL
-
-									break;
-								default:
-									broadcastMessage(socket, playerMask, destinationCode, true);
-							}
-
-							socket.inSeek(returnPoint);
-						}
+					if (destinationCode == DESTINATION_EVERYONE && source != nullptr && source->isNode)
+					{
+						destinationCode = DESTINATION_ALL;
 					}
 
+					relayDatagram(socket, destinationCode, source);
+
 					break;
+				}
 				case DESTINATION_REPLY:
 					// Nothing so far.
 
@@ -1590,6 +2544,177 @@ namespace iosync
 			// Return the default response.
 			return destinationCode;
 		}
+
+		void serverNetworkEngine::relayDatagram(QSocket& socket, networkDestinationCode destinationCode, player* source)
+		{
+			// Local variable(s):
+
+			// The sender is only sent a copy when 'DESTINATION_EVERYONE' is used.
+			player* sender = (destinationCode != DESTINATION_EVERYONE) ? source : nullptr;
+
+			// Check if there's anyone to relay to:
+			if (players.empty() || (destinationCode != DESTINATION_EVERYONE && players.size() <= ((sender != nullptr) ? 1 : 0)))
+				return;
+
+			auto returnPoint = socket.readOffset;
+
+			// Seek back to the beginning.
+			socket.resetRead();
+
+			auto inputFraming = messageHeader::readDatagramFraming(socket);
+
+			/*
+				Messages that don't need to be rewritten (Unreliable, and using our wire-format)
+				are forwarded as they are. Consecutive messages like this are copied as a single run,
+				so they don't need to be re-serialized. Reliable messages still need our own identifiers.
+			*/
+
+			bool verbatim = (inputFraming == framing);
+
+			// Each relayed message is routed to the players subscribed to its channels.
+			resetOutputRoute();
+
+			streamLocation runStart = 0;
+			streamLocation runLength = 0;
+
+			auto flushRun = [this, &socket, &runStart, &runLength] ()
+			{
+				if (runLength > 0)
+				{
+					messageHeader::writeDatagramMarker(socket, framing);
+
+					socket.UwriteBytes(socket.inbuffer + runStart, (size_t)runLength);
+
+					runLength = 0;
+				}
+
+				return;
+			};
+
+			while (socket.canRead())
+			{
+				// Local variable(s):
+				streamLocation startPosition = socket.readOffset;
+
+				messageHeader header;
+				messageFooter footer;
+
+				header.readFrom(socket, footer, inputFraming);
+
+				if (!header.directedHere)
+				{
+					flushRun();
+
+					// Packet forwarding should not be done here.
+					passMessage(header, footer);
+
+					// Continue to the next message.
+					continue;
+				}
+
+				if (header.type == MESSAGE_TYPE_META)
+				{
+					flushRun();
+
+					// Skip this message; meta-data, same as this.
+					passMessage(header, footer);
+
+					continue;
+				}
+
+				auto channels = parseMessageChannels(socket, header);
+
+				// Hold this message for the next "frame", if we're aggregating:
+				if (aggregateFrames && destinationCode == DESTINATION_EVERYONE && verbatim && !footer.isReliable())
+				{
+					passMessage(header, footer);
+
+					frameOutput.insert(frameOutput.end(), (socket.inbuffer + startPosition), (socket.inbuffer + socket.readOffset));
+
+					frameMessages++;
+
+					if (channels != SUBSCRIPTION_CHANNELS_ALL)
+					{
+						frameRoute |= channels;
+
+						frameRoutedMessages++;
+					}
+
+					continue;
+				}
+
+				if (verbatim && !footer.isReliable())
+				{
+					outputMessages++;
+
+					routeMessage(channels);
+
+					// Add this message to the current run.
+					passMessage(header, footer);
+
+					if (runLength == 0)
+						runStart = startPosition;
+
+					runLength = (socket.readOffset - runStart);
+
+					continue;
+				}
+
+				flushRun();
+
+				// Start a new message:
+				auto headerInformation = beginMessage(socket, header.type);
+
+				routeMessage(channels);
+
+				// Write the bytes of this message into the output.
+				socket.UwriteBytes(socket.simulatedUReadBytes(header.packetSize), header.packetSize);
+
+				// Finish the message:
+				if (!footer.isReliable())
+				{
+					finishMessage(socket, headerInformation);
+				}
+				else
+				{
+					auto p = finishReliableMessage(socket, address(), headerInformation);
+		
+					p.destinationCode = destinationCode;
+					p.waitingConnections = subscribers(channels, sender);
+
+					// Add the new packet to the internal container.
+					addReliablePacket(p);
+				}
+
+				// Pass this message's footer; already read it.
+				passFooter(footer);
+			}
+
+			flushRun();
+
+			// Check if everything was held for the next "frame":
+			if (socket.writeOffset == 0)
+			{
+				socket.inSeek(returnPoint);
+
+				return;
+			}
+
+			// Send out the message:
+			switch (destinationCode)
+			{
+				case DESTINATION_EVERYONE:
+					networkEngine::sendMessage(destinationCode, true); // DESTINATION_ALL
+
+					break;
+				default:
+					broadcastMessage(socket, players, sender, destinationCode, true);
+			}
+
+			socket.inSeek(returnPoint);
+
+			return;
+		}
 	}
 
 	namespace exceptions
@@ -50,6 +50,9 @@ namespace iosync
 		typedef unsigned short messageType;
 		typedef unsigned short packetID; // unsigned long long
 
+		// The type used to describe the wire-format of a message.
+		typedef uqchar messageFraming;
+
 		// The type used to deduce/describe the type of a connection.
 		typedef unsigned char connectionType;
 
@@ -59,6 +62,15 @@ namespace iosync
 
 		typedef list<player*> playerList;
 
+		// A dense index assigned to each connected player; used to track per-recipient state compactly.
+		typedef unsigned short playerSlot;
+
+		// A mask of routing "channels"; what each channel represents is up to the application.
+		typedef unsigned int subscriptionChannels;
+
+		// The number of an input "frame" aggregated by a server. (Wraps around)
+		typedef unsigned int frameNumber;
+
 		// Enumerator(s):
 
 		// Useful port-macros:
@@ -123,6 +135,21 @@ namespace iosync
 			PACKET_ID_AUTOMATIC = PACKET_ID_UNRELIABLE,
 		};
 
+		// Supported wire-formats; these are negotiated when connecting:
+		enum messageFramings : messageFraming
+		{
+			// The original format; fixed-size fields, and a trailing footer.
+			MESSAGE_FRAMING_LEGACY = 1,
+
+			// Bit-packed flags and variable-length integers, with the footer's contents placed before the message's data.
+			MESSAGE_FRAMING_COMPACT = 2,
+
+			MESSAGE_FRAMING_LATEST = MESSAGE_FRAMING_COMPACT,
+
+			// Until negotiated, messages use the legacy format.
+			DEFAULT_MESSAGE_FRAMING = MESSAGE_FRAMING_LEGACY,
+		};
+
 		// Reasons a client may be disconnected.
 		enum disconnectionReasons : disconnectionReason
 		{
@@ -133,6 +160,22 @@ namespace iosync
 			DISCONNECTION_REASON_CUSTOM_LOCATION,
 		};
 
+		enum playerSlots : playerSlot
+		{
+			// Used by players that haven't been assigned a slot.
+			PLAYER_SLOT_NONE = USHRT_MAX,
+		};
+
+		enum subscriptionChannelMasks : subscriptionChannels
+		{
+			// Players subscribe to everything by default, and messages without a channel are sent to everyone.
+			SUBSCRIPTION_CHANNELS_ALL = UINT_MAX,
+
+			// The number of gamepads with a channel of their own; the first channel is the keyboard's.
+			// Gamepads with larger identifiers are routed to everyone.
+			SUBSCRIPTION_GAMEPAD_CHANNELS = ((sizeof(subscriptionChannels) * CHAR_BIT) - 1),
+		};
+
 		// Reserved/useful ping macros:
 		enum connectionPings : unsigned short
 		{
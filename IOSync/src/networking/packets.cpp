@@ -15,7 +15,7 @@ namespace iosync
 		// packet:
 
 		// Constructor(s):
-		packet::packet(rawPacket rawData, size_t rawSize, bool canFreeRawData) : size(rawSize)
+		packet::packet(rawPacket rawData, size_t rawSize, bool canFreeRawData) : size(rawSize), framing(DEFAULT_MESSAGE_FRAMING)
 		{
 			if (rawData != rawPacket())
 			{
@@ -26,7 +26,7 @@ namespace iosync
 			}
 		}
 
-		packet::packet(QSocket& socket, size_t readSize)
+		packet::packet(QSocket& socket, size_t readSize) : framing(DEFAULT_MESSAGE_FRAMING)
 		{
 			readFrom(socket, readSize, false);
 		}
@@ -108,6 +108,8 @@ namespace iosync
 			// Calculate the internal-size of this packet.
 			size = (socket.writeOffset-positionInformation.entryPoint);
 
+			framing = positionInformation.framing;
+
 			// Check for buffer "simulation":
 			if (simulated)
 			{
@@ -135,6 +137,9 @@ namespace iosync
 			if (data == nullptr)
 				return false;
 
+			// Compact messages can't be parsed without a marker at the beginning of the datagram.
+			messageHeader::writeDatagramMarker(socket, framing);
+
 			// Write the saved data to 
 			return socket.UwriteBytes(data, size);
 		}
@@ -146,6 +151,63 @@ namespace iosync
 			return destinationAddress.sendWith(socket);
 		}
 
+		// recipientSet:
+
+		// Methods:
+		void recipientSet::add(playerSlot slot)
+		{
+			auto index = (slot / BITS_PER_WORD);
+			auto mask = ((word)1 << (slot % BITS_PER_WORD));
+
+			if (index >= words.size())
+			{
+				words.resize(index + 1, 0);
+			}
+
+			if ((words[index] & mask) == 0)
+			{
+				words[index] |= mask;
+
+				count++;
+			}
+
+			return;
+		}
+
+		bool recipientSet::remove(playerSlot slot)
+		{
+			auto index = (slot / BITS_PER_WORD);
+			auto mask = ((word)1 << (slot % BITS_PER_WORD));
+
+			if (index >= words.size() || (words[index] & mask) == 0)
+				return false;
+
+			words[index] &= ~mask;
+
+			count--;
+
+			return true;
+		}
+
+		bool recipientSet::contains(playerSlot slot) const
+		{
+			auto index = (slot / BITS_PER_WORD);
+
+			if (index >= words.size())
+				return false;
+
+			return ((words[index] & ((word)1 << (slot % BITS_PER_WORD))) != 0);
+		}
+
+		void recipientSet::clear()
+		{
+			words.clear();
+
+			count = 0;
+
+			return;
+		}
+
 		// outbound_packet:
 		
 		// Constructor(s):
@@ -197,7 +259,7 @@ namespace iosync
 					destination.port = socket.msgPort();
 					*/
 
-					destination = socket;
+					destination = engine.senderAddress(socket);
 				}
 
 				return (packetSize_t)engine.sendMessage(socket, destination);
@@ -6,7 +6,10 @@
 
 // Standard library:
 #include <memory>
+#include <vector>
+#include <list>
 #include <chrono>
+#include <climits>
 
 // Namespace(s):
 using namespace std;
@@ -134,6 +137,78 @@ namespace iosync
 			// A managed pointer used to represent shared memory.
 			// This is not always set, as memory could be directly handled by an external source.
 			sharedMemory shared;
+
+			// The wire-format of the serialized message(s) held by this packet.
+			messageFraming framing;
+		};
+
+		// This is a compact set of player-slots. Reliable packets sent to several
+		// players use this to track which recipients have yet to confirm them.
+		struct recipientSet
+		{
+			// Typedefs:
+			typedef unsigned long long word;
+
+			// Enumerator(s):
+			enum recipientSetMetrics : size_t
+			{
+				BITS_PER_WORD = (sizeof(word) * CHAR_BIT),
+			};
+
+			// Methods:
+			void add(playerSlot slot);
+
+			// The return value of this command indicates if 'slot' was in this set.
+			bool remove(playerSlot slot);
+
+			bool contains(playerSlot slot) const;
+
+			void clear();
+
+			inline bool empty() const
+			{
+				return (count == 0);
+			}
+
+			inline size_t size() const
+			{
+				return count;
+			}
+
+			// This calls 'fn' with every slot in this set.
+			template <typename callback>
+			inline void forEach(callback fn) const
+			{
+				for (size_t i = 0; i < words.size(); i++)
+				{
+					auto bits = words[i];
+
+					for (size_t bit = 0; bits != 0; bit++, bits >>= 1)
+					{
+						if ((bits & 1) != 0)
+						{
+							fn((playerSlot)((i * BITS_PER_WORD) + bit));
+						}
+					}
+				}
+
+				return;
+			}
+
+			// Fields:
+			vector<word> words;
+
+			// The number of slots in this set.
+			size_t count = 0;
+		};
+
+		// This describes where a packet is listed in the 'packetsInFlight' of one of its recipients.
+		struct packetLink
+		{
+			// Fields:
+			playerSlot slot;
+
+			size_t position;
 		};
 
 		// 'outbound_packets' represent packets with described destinations.
@@ -239,8 +314,9 @@ namespace iosync
 			// Used when sending to a destination, without an explicit address.
 			networkDestinationCode destinationCode;
 
-			// A list of connections tied to this packet.
-			playerList waitingConnections;
+			// The slots of the connections that have yet to confirm this packet.
+			// When empty, the first confirmation is enough. (Direct packets)
+			recipientSet waitingConnections;
 
 			// A "snapshot" of the time this packet was initially sent.
 			high_resolution_clock::time_point snapshot;
@@ -250,6 +326,12 @@ namespace iosync
 
 			// The reliable identifier of this packet.
 			packetID identifier;
+
+			// The players this packet is listed under. (Managed by servers)
+			vector<packetLink> links;
 		};
+
+		// Typedefs:
+		typedef list<outbound_packet> outboundPacketList;
 	}
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "networking.h"
 #include "reliablePacketManager.h"
 #include "address.h"
+#include "packets.h"
 
 #include <set>
 
@@ -44,6 +45,12 @@ namespace iosync
 			virtual bool hasVirtualAddress() const;
 			virtual bool hasReliablePackets() const override;
 
+			// This specifies if this player needs messages on any of 'channels'. (Unrouted messages are always needed)
+			inline bool subscribedTo(subscriptionChannels channels) const
+			{
+				return (channels == SUBSCRIPTION_CHANNELS_ALL || (subscriptions & channels) != 0);
+			}
+
 			// Operators:
 			virtual bool operator==(const address& addr) const;
 
@@ -68,10 +75,38 @@ namespace iosync
 
 			connectionPing ping;
 
+			// The wire-format negotiated with this player.
+			messageFraming framing = DEFAULT_MESSAGE_FRAMING;
+
+			// This player's dense index; assigned by the 'networkEngine' managing this player.
+			playerSlot slot = PLAYER_SLOT_NONE;
+
+			// The reliable packets this player has yet to confirm. (Or that were sent directly to this player)
+			// Each packet knows where it's listed here, so it may be removed in constant time. (See 'packetLink')
+			vector<outboundPacketList::iterator> packetsInFlight;
+
+			// This player's position in the 'players' list of its server.
+			playerList::iterator position;
+
+			// When this player's server next needs to ping this player, or check if they've timed out.
+			high_resolution_clock::time_point timerDeadline;
+
+			// The routing channels this player needs messages from. (See 'MESSAGE_TYPE_SUBSCRIBE')
+			subscriptionChannels subscriptions = SUBSCRIPTION_CHANNELS_ALL;
+
+			// The number of joining players that have been redirected to this node.
+			size_t redirectedPlayers = 0;
+
 			// Booleans / Flags:
 
 			// This specifies if this connection is being "pinged".
 			bool pinging = false;
+
+			// This specifies if this connection is a relay "node"; nodes re-broadcast traffic to their own players.
+			bool isNode = false;
+
+			// This specifies if this player receives messages sent to the server's multicast group.
+			bool multicastMember = false;
 		};
 
 		struct indirect_player : player
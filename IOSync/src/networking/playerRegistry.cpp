@@ -0,0 +1,214 @@
+// Includes:
+#include "playerRegistry.h"
+
+// Standard library:
+#include <functional>
+
+// Namespace(s):
+namespace iosync
+{
+	namespace networking
+	{
+		// Classes:
+
+		// playerRegistry:
+
+		// Functions:
+		size_t playerRegistry::hashAddress(const address& addr)
+		{
+			// Pack the port beside the IP address, then mix the result.
+			auto output = hash<addressIP>()(addr.IP);
+
+			output ^= ((size_t)addr.port + 0x9E3779B9 + (output << 6) + (output >> 2));
+
+			return output;
+		}
+
+		size_t playerRegistry::hashAddress(const address& addr, const address& vaddr)
+		{
+			auto output = hashAddress(addr);
+
+			output ^= (hashAddress(vaddr) + 0x9E3779B9 + (output << 6) + (output >> 2));
+
+			return output;
+		}
+
+		void playerRegistry::insert(index& table, size_t hash, playerSlot slot)
+		{
+			auto mask = (table.size() - 1);
+
+			for (auto position = (hash & mask); ; position = ((position + 1) & mask))
+			{
+				auto& entry = table[position];
+
+				if (entry.slot == BUCKET_EMPTY || entry.slot == BUCKET_REMOVED)
+				{
+					entry = bucket(hash, slot);
+
+					return;
+				}
+			}
+		}
+
+		bool playerRegistry::erase(index& table, size_t hash, playerSlot slot)
+		{
+			auto mask = (table.size() - 1);
+
+			for (auto position = (hash & mask); ; position = ((position + 1) & mask))
+			{
+				auto& entry = table[position];
+
+				if (entry.slot == BUCKET_EMPTY)
+					return false;
+
+				if (entry.slot == slot)
+				{
+					entry.slot = BUCKET_REMOVED;
+
+					return true;
+				}
+			}
+		}
+
+		// Structures:
+
+		// bucket:
+
+		// Constructor(s):
+		playerRegistry::bucket::bucket(size_t hash, playerSlot slot) : hash(hash), slot(slot) { /* Nothing so far. */ }
+
+		// Constructor(s):
+		playerRegistry::playerRegistry() : usedBuckets(0)
+		{
+			rehash(DEFAULT_PLAYER_REGISTRY_CAPACITY);
+		}
+
+		// Methods:
+		playerSlot playerRegistry::add(player* p)
+		{
+			// Find the lowest free slot:
+			playerSlot slot = 0;
+
+			while (slot < slots.size() && slots[slot] != nullptr)
+			{
+				slot++;
+			}
+
+			if (slot == slots.size())
+			{
+				slots.push_back(nullptr);
+			}
+
+			slots[slot] = p;
+
+			p->slot = slot;
+
+			activeSlots.add(slot);
+
+			// Keep the indices at most three-quarters full. (Removed entries included)
+			if (((usedBuckets + 1) * 4) > (exactIndex.size() * 3))
+			{
+				// Local variable(s):
+				size_t capacity = DEFAULT_PLAYER_REGISTRY_CAPACITY;
+
+				// Rebuild at no more than half-full; this also discards removed entries.
+				while ((activeSlots.size() * 2) > capacity)
+				{
+					capacity <<= 1;
+				}
+
+				rehash(capacity);
+			}
+			else
+			{
+				insert(exactIndex, hashAddress(p->remoteAddress, p->vaddr()), slot);
+				insert(addressIndex, hashAddress(p->remoteAddress), slot);
+
+				usedBuckets++;
+			}
+
+			return slot;
+		}
+
+		bool playerRegistry::remove(player* p)
+		{
+			if (at(p->slot) != p)
+				return false;
+
+			erase(exactIndex, hashAddress(p->remoteAddress, p->vaddr()), p->slot);
+			erase(addressIndex, hashAddress(p->remoteAddress), p->slot);
+
+			slots[p->slot] = nullptr;
+
+			activeSlots.remove(p->slot);
+
+			p->slot = PLAYER_SLOT_NONE;
+
+			return true;
+		}
+
+		void playerRegistry::clear()
+		{
+			for (auto p : slots)
+			{
+				if (p != nullptr)
+				{
+					p->slot = PLAYER_SLOT_NONE;
+				}
+			}
+
+			slots.clear();
+			activeSlots.clear();
+
+			rehash(DEFAULT_PLAYER_REGISTRY_CAPACITY);
+
+			return;
+		}
+
+		player* playerRegistry::get(const address& addr) const
+		{
+			return find(addressIndex, hashAddress(addr), [&addr] (const player* p) { return (p->remoteAddress == addr); });
+		}
+
+		player* playerRegistry::get(const address& addr, const address& vaddr) const
+		{
+			return find(exactIndex, hashAddress(addr, vaddr), [&addr, &vaddr] (const player* p) { return (p->remoteAddress == addr && p->vaddr() == vaddr); });
+		}
+
+		recipientSet playerRegistry::recipients(const player* excluded) const
+		{
+			auto output = activeSlots;
+
+			if (excluded != nullptr)
+			{
+				output.remove(excluded->slot);
+			}
+
+			return output;
+		}
+
+		// Methods (Protected):
+		void playerRegistry::rehash(size_t capacity)
+		{
+			exactIndex.assign(capacity, bucket());
+			addressIndex.assign(capacity, bucket());
+
+			usedBuckets = 0;
+
+			for (playerSlot slot = 0; slot < slots.size(); slot++)
+			{
+				auto p = slots[slot];
+
+				if (p == nullptr)
+					continue;
+
+				insert(exactIndex, hashAddress(p->remoteAddress, p->vaddr()), slot);
+				insert(addressIndex, hashAddress(p->remoteAddress), slot);
+
+				usedBuckets++;
+			}
+
+			return;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+
+// Includes:
+#include "networking.h"
+#include "address.h"
+#include "packets.h"
+#include "player.h"
+
+// Standard library:
+#include <vector>
+
+// Namespace(s):
+using namespace std;
+
+namespace iosync
+{
+	namespace networking
+	{
+		// Enumerator(s):
+		enum playerRegistrySizes : size_t
+		{
+			// The initial number of buckets in each index; this must be a power of two.
+			DEFAULT_PLAYER_REGISTRY_CAPACITY = 16,
+		};
+
+		// Classes:
+
+		/*
+			This maps remote addresses to 'player' objects in constant time.
+
+			Players are stored in a dense slot-array; the slot assigned to a
+			player is kept in its 'slot' field, and may be used as an index.
+
+			Two open-addressing indices (Linear probing) refer to these slots;
+			one keyed on the remote address, and virtual address of a player,
+			and one keyed on just the remote address. (Several "indirect"
+			players may share a remote address; they're all stored in this index)
+		*/
+
+		class playerRegistry
+		{
+			public:
+				// Functions:
+				static size_t hashAddress(const address& addr);
+				static size_t hashAddress(const address& addr, const address& vaddr);
+
+				// Constructor(s):
+				playerRegistry();
+
+				// Methods:
+
+				// This assigns the lowest free slot to 'p', then indexes it.
+				playerSlot add(player* p);
+
+				// This removes 'p' from this registry, and resets its slot.
+				// The return value indicates if 'p' was found.
+				bool remove(player* p);
+
+				void clear();
+
+				player* get(const address& addr) const;
+				player* get(const address& addr, const address& vaddr) const;
+
+				// This retrieves the player assigned to 'slot'. ('nullptr' if this slot is free)
+				inline player* at(playerSlot slot) const
+				{
+					if (slot >= slots.size())
+						return nullptr;
+
+					return slots[slot];
+				}
+
+				// This produces the slots of every player, other than 'excluded'. ('nullptr' excludes nobody)
+				recipientSet recipients(const player* excluded=nullptr) const;
+
+				inline const recipientSet& active() const
+				{
+					return activeSlots;
+				}
+
+				inline size_t size() const
+				{
+					return activeSlots.size();
+				}
+
+				inline bool empty() const
+				{
+					return activeSlots.empty();
+				}
+			protected:
+				// Structures:
+				struct bucket
+				{
+					// Constructor(s):
+					bucket(size_t hash=0, playerSlot slot=BUCKET_EMPTY);
+
+					// Fields:
+					size_t hash;
+
+					playerSlot slot;
+				};
+
+				// Enumerator(s):
+				enum bucketStates : playerSlot
+				{
+					BUCKET_EMPTY = PLAYER_SLOT_NONE,
+
+					// Used in place of removed entries, so probing continues past them.
+					BUCKET_REMOVED = (PLAYER_SLOT_NONE - 1),
+				};
+
+				// Typedefs:
+				typedef vector<bucket> index;
+
+				// Functions:
+				static void insert(index& table, size_t hash, playerSlot slot);
+				static bool erase(index& table, size_t hash, playerSlot slot);
+
+				// Methods (Protected):
+
+				// This probes 'table' for the first entry with 'hash' that satisfies 'predicate'.
+				template <typename predicateFunction>
+				inline player* find(const index& table, size_t hash, predicateFunction predicate) const
+				{
+					auto mask = (table.size() - 1);
+
+					for (auto position = (hash & mask); ; position = ((position + 1) & mask))
+					{
+						const auto& entry = table[position];
+
+						if (entry.slot == BUCKET_EMPTY)
+							return nullptr;
+
+						if (entry.slot != BUCKET_REMOVED && entry.hash == hash)
+						{
+							auto p = slots[entry.slot];
+
+							if (predicate(p))
+								return p;
+						}
+					}
+				}
+
+				// This resizes both indices, discarding removed entries.
+				void rehash(size_t capacity);
+
+				// Fields (Protected):
+
+				// The players assigned to each slot. ('nullptr' marks a free slot)
+				vector<player*> slots;
+
+				// The slots currently in use.
+				recipientSet activeSlots;
+
+				// Keyed on the remote address, and virtual address of each player.
+				index exactIndex;
+
+				// Keyed on the remote address of each player.
+				index addressIndex;
+
+				// The number of buckets in each index which aren't empty. (Including removed entries)
+				size_t usedBuckets;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,357 @@
+// Includes:
+#include "relayShards.h"
+
+// Platform-specific:
+#ifdef PLATFORM_WINDOWS
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+#else
+	#include <sys/types.h>
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+#endif
+
+// Standard library:
+#include <algorithm>
+#include <cstring>
+
+// Namespace(s):
+namespace iosync
+{
+	namespace networking
+	{
+		// Structures:
+
+		// relayShardQueue:
+
+		// Constructor(s):
+		relayShardQueue::relayShardQueue() : head(0), tail(0) { /* Nothing so far. */ }
+
+		// Methods:
+		bool relayShardQueue::push(const uqchar* datagram, size_t size, networkDestinationCode destinationCode)
+		{
+			// Local variable(s):
+			auto position = tail.load(memory_order_relaxed);
+
+			// Check if this queue is full:
+			if ((position - head.load(memory_order_acquire)) >= RELAY_SHARD_QUEUE_CAPACITY)
+				return false;
+
+			auto& e = entries[position % RELAY_SHARD_QUEUE_CAPACITY];
+
+			// Entries keep their buffers, so this only allocates until they're large enough.
+			e.datagram.assign(datagram, (datagram + size));
+			e.destinationCode = destinationCode;
+
+			// Publish this entry to the consumer.
+			tail.store((position + 1), memory_order_release);
+
+			// Return the default response.
+			return true;
+		}
+
+		bool relayShardQueue::pop(QSocket& socket, networkDestinationCode& destinationCode_out)
+		{
+			// Local variable(s):
+			auto position = head.load(memory_order_relaxed);
+
+			if (position == tail.load(memory_order_acquire))
+				return false;
+
+			auto& e = entries[position % RELAY_SHARD_QUEUE_CAPACITY];
+
+			// Every shard's socket has the same buffer-length, so this should always fit:
+			bool loaded = (!e.datagram.empty() && e.datagram.size() <= socket._bufferlength);
+
+			if (loaded)
+			{
+				memcpy(socket.inbuffer, e.datagram.data(), e.datagram.size());
+
+				socket.inbufferlen = e.datagram.size();
+
+				// Seek back to the beginning of the input.
+				socket.resetRead();
+
+				destinationCode_out = e.destinationCode;
+			}
+
+			// Give this entry back to the producer.
+			head.store((position + 1), memory_order_release);
+
+			return loaded;
+		}
+
+		// Classes:
+
+		// relayShardEngine:
+
+		// Constructor(s):
+		relayShardEngine::relayShardEngine(application& parent, size_t shardCount)
+			: relayShardEngine(parent, shardCount, 0)
+		{
+			shards.push_back(this);
+
+			for (size_t i = 1; i < shardCount; i++)
+			{
+				shards.push_back(new relayShardEngine(parent, shardCount, i));
+			}
+
+			// Every shard needs to know about the others.
+			for (size_t i = 1; i < shards.size(); i++)
+			{
+				shards[i]->shards = shards;
+			}
+		}
+
+		relayShardEngine::relayShardEngine(application& parent, size_t shardCount, size_t index)
+			: serverNetworkEngine(parent), inbound(new relayShardQueue[max<size_t>(shardCount, 1)]), index(index), handle(0), running(false) { /* Nothing so far. */ }
+
+		// Destructor(s):
+		relayShardEngine::~relayShardEngine()
+		{
+			close();
+
+			if (index == 0)
+			{
+				for (size_t i = 1; i < shards.size(); i++)
+				{
+					delete shards[i];
+				}
+			}
+
+			delete [] inbound;
+		}
+
+		bool relayShardEngine::close()
+		{
+			// The other shards are stopped first, so nothing is passed to us while closing:
+			if (index == 0)
+			{
+				for (size_t i = 1; i < shards.size(); i++)
+				{
+					auto shard = shards[i];
+
+					shard->running = false;
+
+					if (shard->worker.joinable())
+					{
+						shard->worker.join();
+					}
+
+					shard->close();
+				}
+			}
+
+			// Call the super-class's implementation; our players are told we're closing.
+			auto response = serverNetworkEngine::close();
+
+			if (isOpen)
+			{
+				closeNativeSocket(handle);
+
+				isOpen = false;
+			}
+
+			return response;
+		}
+
+		bool relayShardEngine::open(const addressPort port)
+		{
+			/*
+				Every shard is bound before any of them start, so the kernel spreads
+				players between all of them from the beginning. Players stay with the
+				shard they were given, as long as the number of shards doesn't change.
+			*/
+
+			for (auto shard : shards)
+			{
+				if (!shard->networkEngine::open() || !shard->bind(port))
+				{
+					close();
+
+					return false;
+				}
+			}
+
+			for (size_t i = 1; i < shards.size(); i++)
+			{
+				auto shard = shards[i];
+
+				shard->maximumDirectPlayers = maximumDirectPlayers;
+				shard->aggregateFrames = aggregateFrames;
+				shard->maximumIdleDelay = maximumIdleDelay;
+
+				shard->running = true;
+
+				shard->worker = thread(&relayShardEngine::execute, shard);
+			}
+
+			// Return the default response.
+			return true;
+		}
+
+		// Methods (Public):
+		void relayShardEngine::update()
+		{
+			// Relay what the other shards passed us first, so it's included in this update's "frame".
+			auto queued = relayQueuedDatagrams(this->socket);
+
+			// Call the super-class's implementation.
+			serverNetworkEngine::update();
+
+			handledMessages += queued;
+
+			return;
+		}
+
+		bool relayShardEngine::updateSocket(QSocket& socket)
+		{
+			if (!isOpen)
+				return false;
+
+			return nativeReceive(handle, socket, inputAddress);
+		}
+
+		size_t relayShardEngine::sendDatagram(QSocket& socket, const address& remote, bool resetLength)
+		{
+			// Local variable(s):
+			size_t sent = 0;
+
+			if (isOpen)
+			{
+				sent = nativeSend(handle, socket, remote);
+			}
+
+			if (resetLength)
+			{
+				socket.flushOutput();
+			}
+
+			return sent;
+		}
+
+		address relayShardEngine::senderAddress(const QSocket&) const
+		{
+			return inputAddress;
+		}
+
+		// Methods (Protected):
+		bool relayShardEngine::bind(addressPort port)
+		{
+			// Local variable(s):
+			sockaddr_in local;
+
+			ZeroVariable(local);
+
+			local.sin_family = AF_INET;
+			local.sin_port = htons(port);
+			local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+			auto newHandle = (nativeSocket)::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+			#ifdef PLATFORM_WINDOWS
+				if ((SOCKET)newHandle == INVALID_SOCKET)
+					return false;
+			#else
+				if (newHandle < 0)
+					return false;
+			#endif
+
+			#ifdef NETWORK_RELAY_SHARDS
+				int reuse = 1;
+
+				// Every shard shares our port.
+				if (setsockopt(newHandle, SOL_SOCKET, SO_REUSEPORT, (const char*)&reuse, sizeof(reuse)) != 0)
+				{
+					closeNativeSocket(newHandle);
+
+					return false;
+				}
+			#endif
+
+			if (::bind(newHandle, (const sockaddr*)&local, sizeof(local)) != 0)
+			{
+				closeNativeSocket(newHandle);
+
+				return false;
+			}
+
+			// Received datagrams are polled, so this socket can't block.
+			disableBlocking(newHandle);
+
+			this->handle = newHandle;
+
+			isOpen = true;
+
+			// Return the default response.
+			return true;
+		}
+
+		void relayShardEngine::execute()
+		{
+			// Local variable(s):
+			milliseconds idleDelay = (milliseconds)0;
+
+			while (running)
+			{
+				update();
+
+				// Keep relaying without delay while messages are arriving:
+				if (messagesHandled() > 0)
+				{
+					idleDelay = (milliseconds)0;
+
+					continue;
+				}
+
+				// The longer we're idle, the longer we wait to poll again.
+				idleDelay = min(max((idleDelay * 2), (milliseconds)1), maximumIdleDelay);
+
+				this_thread::sleep_for(idleDelay);
+			}
+
+			return;
+		}
+
+		void relayShardEngine::relayDatagram(QSocket& socket, networkDestinationCode destinationCode, player* source)
+		{
+			// The other shards relay this datagram to their own players:
+			for (auto shard : shards)
+			{
+				if (shard != this)
+				{
+					shard->inbound[index].push(socket.inbuffer, socket.inbufferlen, destinationCode);
+				}
+			}
+
+			// Call the super-class's implementation.
+			serverNetworkEngine::relayDatagram(socket, destinationCode, source);
+
+			return;
+		}
+
+		size_t relayShardEngine::relayQueuedDatagrams(QSocket& socket)
+		{
+			// Local variable(s):
+			size_t datagrams = 0;
+
+			networkDestinationCode destinationCode;
+
+			for (size_t i = 0; i < shards.size(); i++)
+			{
+				if (i == index)
+					continue;
+
+				while (inbound[i].pop(socket, destinationCode))
+				{
+					// The sender isn't one of our players; if they get a copy, it's from their own shard.
+					serverNetworkEngine::relayDatagram(socket, destinationCode, nullptr);
+
+					datagrams++;
+				}
+			}
+
+			return datagrams;
+		}
+	}
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+// Includes:
+#include "networkEngine.h"
+#include "multicast.h"
+
+// Standard library:
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// Preprocessor related:
+#ifdef PLATFORM_LINUX
+	// Sharing a port between sockets (With 'SO_REUSEPORT') spreads datagrams by their sender on Linux.
+	#define NETWORK_RELAY_SHARDS
+#endif
+
+// Namespace(s):
+namespace iosync
+{
+	namespace networking
+	{
+		// Enumerator(s):
+		enum relayShardMetrics : unsigned int
+		{
+			// The number of datagrams a shard may hold from each of the other shards.
+			RELAY_SHARD_QUEUE_CAPACITY = 256,
+
+			// The longest the other shards wait between polls by default, in milliseconds. Waits double from one millisecond while idle.
+			DEFAULT_RELAY_SHARD_IDLE_DELAY = 16,
+		};
+
+		// Structures:
+
+		/*
+			This passes datagrams from one shard to another, without locking.
+
+			Only one thread may 'push', and only one thread may 'pop'. Datagrams pushed
+			while this queue is full are dropped, as a socket would with a full buffer.
+		*/
+
+		struct relayShardQueue
+		{
+			// Structures:
+			struct entry
+			{
+				vector<uqchar> datagram;
+
+				networkDestinationCode destinationCode;
+			};
+
+			// Constructor(s):
+			relayShardQueue();
+
+			// Methods:
+
+			// The return value of this command indicates if the datagram was queued.
+			bool push(const uqchar* datagram, size_t size, networkDestinationCode destinationCode);
+
+			// This loads the oldest datagram into the input-buffer of 'socket'. The return value indicates if one was loaded.
+			bool pop(QSocket& socket, networkDestinationCode& destinationCode_out);
+
+			// Fields:
+			entry entries[RELAY_SHARD_QUEUE_CAPACITY];
+
+			atomic<size_t> head;
+			atomic<size_t> tail;
+		};
+
+		// Classes:
+
+		/*
+			This is a relay-only server which spreads its players across several threads ("shards").
+
+			Each shard owns a native socket bound to the same port. Since the port is shared
+			with 'SO_REUSEPORT', the kernel delivers each player's datagrams to the same shard,
+			and replies leave from the port the player is already talking to.
+
+			Shards handle joins, pings, and reliable messages for their own players. Broadcasts
+			are relayed to the shard's players, then passed to every other shard, which relays
+			them to its own players. (See 'relayShardQueue') Each shard aggregates its own "frames".
+
+			Application call-backs are made from every shard's thread, so these should only be used
+			by applications that don't handle messages themselves. (Relays) Multicast groups,
+			and joining a parent server aren't supported; player limits apply to each shard.
+		*/
+
+		class relayShardEngine : public serverNetworkEngine
+		{
+			public:
+				// Constructor(s):
+				relayShardEngine(application& parent, size_t shardCount);
+
+				// Destructor(s):
+				virtual ~relayShardEngine();
+
+				virtual bool close() override;
+
+				// This opens every shard on 'port', then starts the threads of the other shards.
+				virtual bool open(addressPort port=DEFAULT_PORT) override;
+
+				// Methods (Public):
+				virtual void update() override;
+
+				virtual bool updateSocket(QSocket& socket) override;
+
+				virtual size_t sendDatagram(QSocket& socket, const address& remote, bool resetLength=true) override;
+
+				virtual address senderAddress(const QSocket& socket) const override;
+
+				inline size_t shardCount() const
+				{
+					return shards.size();
+				}
+
+				// Fields:
+
+				// The longest the other shards wait between polls while idle.
+				milliseconds maximumIdleDelay = (milliseconds)DEFAULT_RELAY_SHARD_IDLE_DELAY;
+			protected:
+				// Constructor(s) (Protected):
+
+				// This is used to create the other shards. (See 'shards')
+				relayShardEngine(application& parent, size_t shardCount, size_t index);
+
+				// Methods (Protected):
+
+				// This binds our native socket to 'port'. The return value indicates if this was done.
+				bool bind(addressPort port);
+
+				// This acts as the main loop of the other shards.
+				void execute();
+
+				// Datagrams our own players broadcast are passed to the other shards.
+				virtual void relayDatagram(QSocket& socket, networkDestinationCode destinationCode, player* source) override;
+
+				// This relays the datagrams passed to us by the other shards. The number of datagrams is returned.
+				size_t relayQueuedDatagrams(QSocket& socket);
+
+				// Fields (Protected):
+
+				// Every shard, including this one. (The first shard owns the others)
+				vector<relayShardEngine*> shards;
+
+				// The datagrams passed to us, indexed by the shard that sent them.
+				relayShardQueue* inbound;
+
+				size_t index;
+
+				nativeSocket handle;
+
+				// The address of the datagram last received. (See 'senderAddress')
+				address inputAddress;
+
+				thread worker;
+
+				atomic<bool> running;
+
+				// Booleans / Flags:
+				bool isOpen = false;
+		};
+	}
+}
@@ -31,21 +31,38 @@ using namespace iosync::devices;
 // Global variable(s):
 
 // Shared-memory related:
-LPVOID sharedBuffer = NULL;
+gamepad::sharedGamepadMemory gamepad::sharedMemory = gamepad::sharedGamepadMemory(SHARED_GAMEPAD_MEMORY_NAME);
 
-XINPUT_STATE* gamepadStates = nullptr;
-bool* pluggedIn = nullptr;
-
-HANDLE gamepad::sharedMemory = NULL;
+// The last consistent state read for each gamepad; used if a state is being written for too long.
+XINPUT_STATE gamepadStates[MAX_GAMEPADS] = {};
 
 // Functions:
 void detachSharedMemory()
 {
-	// Un-map the shared memory segment.
-	gamepad::__winnt__unmapSharedMemory(sharedBuffer);
+	// Un-map the shared memory segment, and close our connection to it.
+	gamepad::closeSharedMemory();
+
+	return;
+}
+
+inline bool pluggedIn(DWORD dwUserIndex)
+{
+	return gamepad::getGamepadConnected((gamepadID)dwUserIndex);
+}
+
+// This takes a consistent snapshot of the gamepad specified. (See 'sharedStateMemory::read')
+inline void readGamepadState(DWORD dwUserIndex, PXINPUT_STATE pState)
+{
+	// Local variable(s):
+	XINPUT_STATE state;
+
+	// If the state couldn't be read, the last consistent state is used.
+	if (gamepad::sharedMemory.read((size_t)dwUserIndex, state))
+	{
+		gamepadStates[dwUserIndex] = state;
+	}
 
-	// Close the shared memory connection.
-	gamepad::__winnt__closeSharedMemory();
+	*pState = gamepadStates[dwUserIndex];
 
 	return;
 }
@@ -71,7 +88,7 @@ extern "C"
 
 	DWORD WINAPI XInputGetBatteryInformation(DWORD dwUserIndex, BYTE devType, PXINPUT_BATTERY_INFORMATION battery)
 	{
-		if (!pluggedIn[dwUserIndex])
+		if (!pluggedIn(dwUserIndex))
 		{
 			return REAL_XINPUT::XInputGetBatteryInformation(dwUserIndex, devType, battery);
 		}
@@ -83,7 +100,7 @@ extern "C"
 
 	DWORD WINAPI XInputGetKeystroke(DWORD dwUserIndex, DWORD dwReserved, PXINPUT_KEYSTROKE pKeyStroke)
 	{
-		if (!pluggedIn[dwUserIndex])
+		if (!pluggedIn(dwUserIndex))
 		{
 			return REAL_XINPUT::XInputGetKeystroke(dwUserIndex, dwReserved, pKeyStroke);
 		}
@@ -95,7 +112,7 @@ extern "C"
 
 	DWORD WINAPI XInputGetAudioDeviceIds(DWORD dwUserIndex, LPWSTR pRenderDeviceId, PUINT renderCount, LPWSTR captureDeviceId, PUINT captureCount)
 	{
-		if (!pluggedIn[dwUserIndex])
+		if (!pluggedIn(dwUserIndex))
 		{
 			return REAL_XINPUT::XInputGetAudioDeviceIds(dwUserIndex, pRenderDeviceId, renderCount, captureDeviceId, captureCount);
 		}
@@ -107,7 +124,7 @@ extern "C"
 
 	DWORD WINAPI XInputSetState(DWORD dwUserIndex, PXINPUT_VIBRATION pVibration)
 	{
-		if (!pluggedIn[dwUserIndex])
+		if (!pluggedIn(dwUserIndex))
 		{
 			return REAL_XINPUT::XInputSetState(dwUserIndex, pVibration);
 		}
@@ -119,9 +136,9 @@ extern "C"
 
 	DWORD WINAPI XInputGetState(DWORD dwUserIndex, PXINPUT_STATE pState)
 	{
-		if (pluggedIn[dwUserIndex])
+		if (pluggedIn(dwUserIndex))
 		{
-			*pState = gamepadStates[dwUserIndex];
+			readGamepadState(dwUserIndex, pState);
 
 			return ERROR_SUCCESS;
 		}
@@ -131,9 +148,9 @@ extern "C"
 
 	DWORD WINAPI XInputGetStateEx(DWORD dwUserIndex, PXINPUT_STATE pState)
 	{
-		if (pluggedIn[dwUserIndex])
+		if (pluggedIn(dwUserIndex))
 		{
-			*pState = gamepadStates[dwUserIndex];
+			readGamepadState(dwUserIndex, pState);
 
 			//return ::XInputGetState(dwUserIndex, pState);
 
@@ -145,7 +162,7 @@ extern "C"
 
 	DWORD WINAPI XInputGetCapabilities(DWORD dwUserIndex, DWORD dwFlags, PXINPUT_CAPABILITIES pCapabilities)
 	{
-		if (pluggedIn[dwUserIndex])
+		if (pluggedIn(dwUserIndex))
 		{
 			ZeroVariable(*pCapabilities);
 
@@ -183,7 +200,7 @@ extern "C"
 						freopen("CONOUT$", "w", stdout);
 					#endif
 
-					auto sharedMemoryResponse = gamepad::__winnt__openSharedMemory();
+					auto sharedMemoryResponse = gamepad::openSharedMemory();
 
 					if (sharedMemoryResponse == SHARED_MEMORY_ALLOCATED || sharedMemoryResponse == SHARED_MEMORY_ALREADY_ALLOCATED)
 					{
@@ -191,14 +208,7 @@ extern "C"
 							auto PID = getPID();
 						#endif
 
-						sharedBuffer = gamepad::__winnt__mapSharedMemory(FILE_MAP_READ);
-
-						if (sharedBuffer == NULL)
-							return FALSE;
-
-						pluggedIn = (bool*)gamepad::__winnt__sharedMemory_getPluggedInOffset(sharedBuffer);
-						gamepadStates = (nativeGamepad*)gamepad::__winnt__sharedMemory_getStatesOffset(sharedBuffer);
-
+						// The segment is mapped once, and stays mapped until we detach.
 						bool injected = false;
 						bool shouldInject = true;
 